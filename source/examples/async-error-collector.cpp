@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Error {
+  int queueId;
+  std::exception_ptr error;
+};
+
+// Collects the asynchronous errors of many queues. Pushing an error never
+// takes a lock, so the asynchronous handlers do not wait for each other or
+// for the consumer. The consumer takes all the errors at once.
+class ErrorCollector {
+public:
+  ~ErrorCollector() { takeAll(); }
+
+  void push(int queueId, std::exception_ptr e) {
+    Node *n = new Node{{queueId, e}, head.load(std::memory_order_relaxed)};
+    while (!head.compare_exchange_weak(n->next, n, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  // The errors in the order they were pushed
+  std::vector<Error> takeAll() {
+    Node *n = head.exchange(nullptr, std::memory_order_acquire);
+    std::vector<Error> errors;
+    while (n) {
+      errors.push_back(n->error);
+      Node *next = n->next;
+      delete n;
+      n = next;
+    }
+    std::reverse(errors.begin(), errors.end());
+    return errors;
+  }
+
+  // An asynchronous handler that pushes the errors of queue `queueId`
+  sycl::async_handler handlerFor(int queueId) {
+    return [this, queueId](sycl::exception_list exceptions) {
+      for (const std::exception_ptr &e : exceptions)
+        push(queueId, e);
+    };
+  }
+
+private:
+  struct Node {
+    Error error;
+    Node *next;
+  };
+  std::atomic<Node *> head{nullptr};
+};
+
+enum class Checking { none, waitEach, collector };
+
+struct Result {
+  double seconds;
+  size_t reported;
+  std::string message;
+};
+
+class Step;
+
+constexpr int numThreads = 4;
+constexpr int submits = 5000;
+
+// Each thread submits to its own queue. Every errorPeriod-th command is a
+// host task that throws. With Checking::collector a separate thread calls
+// throw_asynchronous on every queue each millisecond and reports what the
+// collector has.
+Result run(const sycl::device &dev, Checking mode, int errorPeriod) {
+  ErrorCollector collector;
+  std::vector<sycl::queue> queues;
+  for (int t = 0; t < numThreads; t++) {
+    if (mode == Checking::none)
+      queues.emplace_back(dev, sycl::property::queue::in_order());
+    else
+      queues.emplace_back(dev, collector.handlerFor(t),
+                          sycl::property::queue::in_order());
+  }
+
+  Result result{0.0, 0, ""};
+  auto report = [&]() {
+    for (const Error &e : collector.takeAll()) {
+      try {
+        std::rethrow_exception(e.error);
+      } catch (const sycl::exception &ex) {
+        if (result.reported++ == 0)
+          result.message =
+              "queue " + std::to_string(e.queueId) + ": " + ex.what();
+      }
+    }
+  };
+
+  std::atomic<bool> stop{false};
+  std::thread drain;
+  if (mode == Checking::collector) {
+    drain = std::thread([&]() {
+      while (!stop.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        for (sycl::queue &q : queues)
+          q.throw_asynchronous();
+        report();
+      }
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t]() {
+      sycl::queue &q = queues[t];
+      float *data = sycl::malloc_device<float>(256, q);
+      q.fill(data, 0.0f, 256);
+      for (int i = 1; i <= submits; i++) {
+        if (errorPeriod && i % errorPeriod == 0) {
+          q.submit([&](sycl::handler &cgh) {
+            cgh.host_task([]() {
+              throw sycl::exception(sycl::make_error_code(sycl::errc::runtime),
+                                    "Injected error");
+            });
+          });
+        } else {
+          q.parallel_for<Step>(256, [=](sycl::id<1> j) { data[j] += 1.0f; });
+        }
+        if (mode == Checking::waitEach)
+          q.wait_and_throw();
+      }
+      q.wait();
+      sycl::free(data, q);
+    });
+  }
+  for (std::thread &t : threads)
+    t.join();
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  result.seconds = d.count();
+
+  stop = true;
+  if (drain.joinable())
+    drain.join();
+  // Errors that arrived after the last periodic drain
+  for (sycl::queue &q : queues)
+    q.wait_and_throw();
+  report();
+  return result;
+}
+
+int main() {
+  constexpr int errorPeriod = 500;
+  sycl::device dev;
+  run(dev, Checking::none, 0);
+
+  struct Case {
+    const char *name;
+    Checking mode;
+    int errorPeriod;
+  };
+  const Case cases[] = {
+      {"no checking", Checking::none, 0},
+      {"wait_and_throw each", Checking::waitEach, 0},
+      {"collector", Checking::collector, 0},
+      {"collector, errors", Checking::collector, errorPeriod}};
+
+  std::cout << std::left << std::setw(22) << "error checking" << std::right
+            << std::setw(14) << "submits/s" << std::setw(10) << "errors"
+            << "\n";
+  bool ok = true;
+  std::string message;
+  for (const Case &c : cases) {
+    Result r = run(dev, c.mode, c.errorPeriod);
+    size_t expected =
+        c.errorPeriod ? numThreads * (submits / c.errorPeriod) : 0;
+    ok = ok && r.reported == expected;
+    if (!r.message.empty())
+      message = r.message;
+    std::cout << std::left << std::setw(22) << c.name << std::right
+              << std::fixed << std::setprecision(0) << std::setw(14)
+              << numThreads * submits / r.seconds << std::setw(10)
+              << r.reported << "\n";
+  }
+  std::cout << "Reported error: " << message << "\n";
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// Results of the probe kernels on a device
+struct Probe {
+  double gbs;
+  double gflops;
+};
+
+class ProbeCopy;
+class ProbeFma;
+
+// Best of three profiled runs, after one warm-up run
+template <typename Fn> double bestSeconds(Fn launch) {
+  launch().wait();
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int r = 0; r < 3; r++) {
+    sycl::event e = launch();
+    e.wait();
+    best = std::min(
+        best,
+        e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+            e.get_profiling_info<
+                sycl::info::event_profiling::command_start>());
+  }
+  return best / 1.0e9;
+}
+
+// Short bandwidth and compute measurements, a fraction of a second each
+Probe probe(const sycl::device &d) {
+  constexpr size_t n = 1 << 24;
+  constexpr int fmas = 64;
+  sycl::queue q{d, sycl::property::queue::enable_profiling()};
+  float *a = sycl::malloc_device<float>(n, q);
+  float *b = sycl::malloc_device<float>(n, q);
+  q.fill(a, 1.0f, n).wait();
+
+  double copy = bestSeconds([&]() {
+    return q.parallel_for<ProbeCopy>(n, [=](sycl::id<1> i) { b[i] = a[i]; });
+  });
+  double compute = bestSeconds([&]() {
+    return q.parallel_for<ProbeFma>(n, [=](sycl::id<1> i) {
+      float x = a[i];
+      for (int k = 0; k < fmas; k++)
+        x = sycl::fma(x, 0.999f, 0.001f);
+      b[i] = x;
+    });
+  });
+
+  sycl::free(a, q);
+  sycl::free(b, q);
+  return {2.0 * n * sizeof(float) / copy / 1e9,
+          2.0 * n * fmas / compute / 1e9};
+}
+
+// Combines the probe results with device queries. The weights suit an
+// application that is mostly memory bound and benefits from double
+// precision: a device usually has tens of FLOPs per byte of bandwidth, so
+// GFLOPS weighs a hundredth of GB/s and bandwidth dominates the score.
+// Another application would pick other weights.
+int score(const sycl::device &d, const Probe &p) {
+  double memGiB = d.get_info<sycl::info::device::global_mem_size>() /
+                  (1024.0 * 1024.0 * 1024.0);
+  double s = p.gbs + 0.01 * p.gflops + std::min(memGiB, 16.0);
+  if (d.has(sycl::aspect::fp64))
+    s += 10.0;
+  if (d.has(sycl::aspect::fp16))
+    s += 5.0;
+  // Breaks ties between otherwise equal devices
+  s += 0.01 * d.get_info<sycl::info::device::max_compute_units>();
+  return static_cast<int>(10.0 * s);
+}
+
+// Device selector that probes each device once. The probe results are
+// saved in a cache file, keyed by the device name and the driver version,
+// so later runs select the device without running the probes. A new
+// driver version changes the key and the device is probed again.
+class BenchmarkSelector {
+public:
+  struct Entry {
+    Probe probe;
+    bool probed; // by this process, rather than read from the cache
+  };
+
+  explicit BenchmarkSelector(const fs::path &cacheFile)
+      : state{std::make_shared<State>()} {
+    state->path = cacheFile;
+    std::ifstream f{cacheFile};
+    std::string line;
+    while (std::getline(f, line)) {
+      std::istringstream fields{line};
+      Probe p;
+      std::string key;
+      if (fields >> p.gbs >> p.gflops && std::getline(fields >> std::ws, key))
+        state->entries[key] = Entry{p, false};
+    }
+  }
+
+  // Devices whose probe fails get a negative score and are never selected
+  int operator()(const sycl::device &d) const {
+    std::string k = key(d);
+    auto it = state->entries.find(k);
+    if (it == state->entries.end()) {
+      try {
+        it = state->entries.emplace(k, Entry{probe(d), true}).first;
+      } catch (const sycl::exception &) {
+        return -1;
+      }
+      save();
+    }
+    return score(d, it->second.probe);
+  }
+
+  const Entry *entry(const sycl::device &d) const {
+    auto it = state->entries.find(key(d));
+    return it == state->entries.end() ? nullptr : &it->second;
+  }
+
+private:
+  static std::string key(const sycl::device &d) {
+    return d.get_info<sycl::info::device::name>() + " / " +
+           d.get_info<sycl::info::device::driver_version>();
+  }
+
+  void save() const {
+    std::ofstream f{state->path};
+    f << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto &[k, e] : state->entries)
+      f << e.probe.gbs << " " << e.probe.gflops << " " << k << "\n";
+  }
+
+  // Shared by the copies of the selector that the SYCL runtime makes
+  struct State {
+    fs::path path;
+    std::map<std::string, Entry> entries;
+  };
+  std::shared_ptr<State> state;
+};
+
+template <typename Fn> double timeMs(Fn f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::milli> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// The cache file is the first argument, by default a file in the temporary
+// directory
+int main(int argc, char *argv[]) {
+  fs::path cacheFile = argc > 1 ? fs::path{argv[1]}
+                                : fs::temp_directory_path() /
+                                      "sycl-device-scores.txt";
+  std::cout << std::fixed << std::setprecision(1);
+
+  // Select a device, then select again with a new selector that only has
+  // the cache file
+  sycl::device selected[2];
+  for (int run = 0; run < 2; run++) {
+    BenchmarkSelector selector{cacheFile};
+    double ms = timeMs([&]() { selected[run] = sycl::device{selector}; });
+    std::cout << (run == 0 ? "Selection" : "Selection from the cache")
+              << " took " << ms << " ms\n";
+
+    if (run == 0) {
+      std::cout << std::left << std::setw(40) << "device" << std::right
+                << std::setw(10) << "GB/s" << std::setw(10) << "GFLOPS"
+                << std::setw(8) << "score" << std::setw(8) << "probe"
+                << "\n";
+      for (const sycl::device &d : sycl::device::get_devices()) {
+        const BenchmarkSelector::Entry *e = selector.entry(d);
+        if (!e)
+          continue;
+        std::string name = d.get_info<sycl::info::device::name>();
+        std::cout << std::left << std::setw(40) << name.substr(0, 38)
+                  << std::right << std::setw(10) << e->probe.gbs
+                  << std::setw(10) << e->probe.gflops << std::setw(8)
+                  << selector(d) << std::setw(8)
+                  << (e->probed ? "new" : "cached") << "\n";
+      }
+    }
+    std::cout << "Selected: "
+              << selected[run].get_info<sycl::info::device::name>() << "\n";
+  }
+
+  bool ok = selected[0] == selected[1];
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,275 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+// An undirected graph in compressed sparse row format: the neighbors of
+// vertex v are col[rowPtr[v]] to col[rowPtr[v + 1] - 1]
+struct Csr {
+  size_t vertices = 0;
+  std::vector<uint32_t> rowPtr, col;
+};
+
+// A recursive matrix (RMAT) graph with 2^scale vertices: each edge falls
+// into one quadrant of the adjacency matrix with probabilities a, b, c
+// and d, recursively, which gives the skewed degrees of real networks.
+// Vertex numbers are shuffled so high-degree vertices are not clustered.
+Csr rmat(int scale, size_t edges) {
+  constexpr float a = 0.57f, b = 0.19f, c = 0.19f;
+  std::mt19937 gen{11};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  Csr g;
+  g.vertices = size_t{1} << scale;
+  std::vector<uint32_t> perm(g.vertices);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::shuffle(perm.begin(), perm.end(), gen);
+
+  std::vector<std::pair<uint32_t, uint32_t>> list;
+  for (size_t e = 0; e < edges; e++) {
+    uint32_t s = 0, d = 0;
+    for (int bit = 0; bit < scale; bit++) {
+      float r = dist(gen);
+      s = s << 1 | (r >= a + b);
+      d = d << 1 | ((r >= a && r < a + b) || r >= a + b + c);
+    }
+    if (s != d)
+      list.emplace_back(perm[s], perm[d]);
+  }
+
+  // Both directions of every edge
+  g.rowPtr.assign(g.vertices + 1, 0);
+  for (auto [s, d] : list) {
+    g.rowPtr[s + 1]++;
+    g.rowPtr[d + 1]++;
+  }
+  std::partial_sum(g.rowPtr.begin(), g.rowPtr.end(), g.rowPtr.begin());
+  std::vector<uint32_t> next(g.rowPtr.begin(), g.rowPtr.end() - 1);
+  g.col.resize(g.rowPtr.back());
+  for (auto [s, d] : list) {
+    g.col[next[s]++] = d;
+    g.col[next[d]++] = s;
+  }
+  return g;
+}
+
+// Levels of a breadth-first search on the host, -1 for unreached vertices
+std::vector<int32_t> hostBfs(const Csr &g, uint32_t source) {
+  std::vector<int32_t> level(g.vertices, -1);
+  std::vector<uint32_t> queue{source};
+  level[source] = 0;
+  for (size_t k = 0; k < queue.size(); k++) {
+    uint32_t v = queue[k];
+    for (uint32_t e = g.rowPtr[v]; e < g.rowPtr[v + 1]; e++) {
+      uint32_t u = g.col[e];
+      if (level[u] == -1) {
+        level[u] = level[v] + 1;
+        queue.push_back(u);
+      }
+    }
+  }
+  return level;
+}
+
+// The graph in device memory
+struct DeviceGraph {
+  size_t vertices;
+  uint32_t *rowPtr, *col;
+};
+
+// Size of the next frontier, in vertices and in edges to explore
+struct Counts {
+  uint32_t vertices, edges;
+};
+
+template <typename T>
+using Atomic = sycl::atomic_ref<T, sycl::memory_order::relaxed,
+                                sycl::memory_scope::device,
+                                sycl::access::address_space::global_space>;
+
+// Adds u, with its degree, to the next frontier
+void append(const DeviceGraph &g, uint32_t *next, Counts *counts,
+            uint32_t u) {
+  next[Atomic<uint32_t>{counts->vertices}.fetch_add(1)] = u;
+  Atomic<uint32_t>{counts->edges} += g.rowPtr[u + 1] - g.rowPtr[u];
+}
+
+class TopDown;
+class BottomUp;
+
+// Top-down step: each frontier vertex claims its unvisited neighbors. Of
+// the work-items that find the same neighbor, only the one whose
+// compare-exchange succeeds appends it.
+sycl::event topDown(sycl::queue &q, DeviceGraph g, int32_t *level,
+                    const uint32_t *frontier, uint32_t frontierSize,
+                    uint32_t *next, Counts *counts, int32_t depth) {
+  return q.parallel_for<TopDown>(frontierSize, [=](sycl::id<1> i) {
+    uint32_t v = frontier[i];
+    for (uint32_t e = g.rowPtr[v]; e < g.rowPtr[v + 1]; e++) {
+      uint32_t u = g.col[e];
+      Atomic<int32_t> lu{level[u]};
+      int32_t unvisited = -1;
+      if (lu.load() == -1 && lu.compare_exchange_strong(unvisited, depth + 1))
+        append(g, next, counts, u);
+    }
+  });
+}
+
+// Bottom-up step: each unvisited vertex looks for a neighbor in the
+// frontier and stops at the first one. When the frontier is a large part
+// of the graph this checks far fewer edges than the top-down step, and
+// needs no compare-exchange since every work-item only writes its own
+// vertex.
+sycl::event bottomUp(sycl::queue &q, DeviceGraph g, int32_t *level,
+                     uint32_t *next, Counts *counts, int32_t depth) {
+  return q.parallel_for<BottomUp>(g.vertices, [=](sycl::id<1> i) {
+    uint32_t v = static_cast<uint32_t>(i[0]);
+    if (level[v] != -1)
+      return;
+    for (uint32_t e = g.rowPtr[v]; e < g.rowPtr[v + 1]; e++) {
+      if (Atomic<int32_t>{level[g.col[e]]}.load() == depth) {
+        Atomic<int32_t>{level[v]}.store(depth + 1);
+        append(g, next, counts, v);
+        return;
+      }
+    }
+  });
+}
+
+// Parameters of the direction switch, from Beamer et al., "Direction-
+// Optimizing Breadth-First Search"
+constexpr uint32_t alpha = 14, beta = 24;
+
+// One level per iteration, each level one kernel. Returns the number of
+// bottom-up levels.
+int bfs(sycl::queue &q, const DeviceGraph &g, int32_t *level,
+        uint32_t *frontier, uint32_t *next, Counts *counts, uint32_t source,
+        uint32_t totalEdges, bool optimizeDirection) {
+  sycl::event reset = q.fill(level, int32_t{-1}, g.vertices);
+  q.submit([&](sycl::handler &cgh) {
+    cgh.depends_on(reset);
+    cgh.fill(level + source, int32_t{0}, 1);
+  });
+  q.fill(frontier, source, 1);
+  uint32_t ends[2];
+  q.copy(g.rowPtr + source, ends, 2);
+  q.wait();
+  Counts current{1, ends[1] - ends[0]};
+
+  uint32_t unexplored = totalEdges;
+  bool up = false;
+  int bottomUpLevels = 0;
+  for (int32_t depth = 0; current.vertices > 0; depth++) {
+    // Bottom-up when the frontier has many of the edges left to explore,
+    // top-down again when the frontier is small
+    if (optimizeDirection && !up && current.edges > unexplored / alpha)
+      up = true;
+    else if (up && current.vertices < g.vertices / beta)
+      up = false;
+    unexplored -= current.edges;
+
+    *counts = Counts{0, 0};
+    if (up) {
+      bottomUp(q, g, level, next, counts, depth).wait();
+      bottomUpLevels++;
+    } else {
+      topDown(q, g, level, frontier, current.vertices, next, counts, depth)
+          .wait();
+    }
+    current = *counts;
+    std::swap(frontier, next);
+  }
+  return bottomUpLevels;
+}
+
+// The scale of the graph is the first argument
+int main(int argc, char *argv[]) {
+  int scale = argc > 1 ? std::atoi(argv[1]) : 20;
+  constexpr int edgeFactor = 16;
+  constexpr size_t numSearches = 8;
+
+  Csr h = rmat(scale, size_t{edgeFactor} << scale);
+  size_t edges = h.col.size();
+  std::cout << "RMAT graph: " << h.vertices << " vertices, " << edges / 2
+            << " edges\n";
+
+  sycl::queue q;
+  DeviceGraph g{h.vertices, sycl::malloc_device<uint32_t>(h.vertices + 1, q),
+                sycl::malloc_device<uint32_t>(edges, q)};
+  int32_t *level = sycl::malloc_device<int32_t>(h.vertices, q);
+  uint32_t *frontier = sycl::malloc_device<uint32_t>(h.vertices, q);
+  uint32_t *next = sycl::malloc_device<uint32_t>(h.vertices, q);
+  Counts *counts = sycl::malloc_shared<Counts>(1, q);
+  q.copy(h.rowPtr.data(), g.rowPtr, h.vertices + 1);
+  q.copy(h.col.data(), g.col, edges);
+  q.wait();
+
+  // Sources with at least one edge
+  std::mt19937 gen{13};
+  std::uniform_int_distribution<uint32_t> pick{
+      0, static_cast<uint32_t>(h.vertices - 1)};
+  std::vector<uint32_t> sources;
+  while (sources.size() < numSearches) {
+    uint32_t s = pick(gen);
+    if (h.rowPtr[s + 1] > h.rowPtr[s])
+      sources.push_back(s);
+  }
+
+  std::cout << std::left << std::setw(22) << "search" << std::right
+            << std::setw(12) << "ms/search" << std::setw(10) << "GTEPS"
+            << std::setw(18) << "bottom-up levels" << "\n";
+  bool ok = true;
+  std::vector<int32_t> result(h.vertices);
+  for (bool optimizeDirection : {false, true}) {
+    // Compile the kernels before timing
+    bfs(q, g, level, frontier, next, counts, sources[0],
+        static_cast<uint32_t>(edges), optimizeDirection);
+
+    double seconds = 0, traversed = 0;
+    int bottomUpLevels = 0;
+    for (uint32_t s : sources) {
+      auto start = std::chrono::steady_clock::now();
+      bottomUpLevels += bfs(q, g, level, frontier, next, counts, s,
+                            static_cast<uint32_t>(edges), optimizeDirection);
+      std::chrono::duration<double> d =
+          std::chrono::steady_clock::now() - start;
+      seconds += d.count();
+
+      // Check the levels, and count the edges of the reached part of the
+      // graph, as the Graph500 benchmark does
+      q.copy(level, result.data(), h.vertices).wait();
+      std::vector<int32_t> ref = hostBfs(h, s);
+      ok = ok && result == ref;
+      for (size_t v = 0; v < h.vertices; v++)
+        if (ref[v] != -1)
+          traversed += (h.rowPtr[v + 1] - h.rowPtr[v]) / 2.0;
+    }
+    std::cout << std::left << std::setw(22)
+              << (optimizeDirection ? "direction-optimizing" : "top-down")
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << seconds * 1e3 / numSearches
+              << std::setw(10) << traversed / seconds / 1e9
+              << std::setprecision(1) << std::setw(18)
+              << static_cast<double>(bottomUpLevels) / numSearches << "\n";
+  }
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(g.rowPtr, q);
+  sycl::free(g.col, q);
+  sycl::free(level, q);
+  sycl::free(frontier, q);
+  sycl::free(next, q);
+  sycl::free(counts, q);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Bit operations implemented either with the SYCL integer built-ins or with
+// loops over the 32 bits of a word
+
+template <bool Builtin> uint32_t countOnes(uint32_t w) {
+  if constexpr (Builtin) {
+    return sycl::popcount(w);
+  } else {
+    uint32_t c = 0;
+    for (int k = 0; k < 32; k++)
+      c += (w >> k) & 1u;
+    return c;
+  }
+}
+
+template <bool Builtin> uint32_t trailingZeros(uint32_t w) {
+  if constexpr (Builtin) {
+    return sycl::ctz(w);
+  } else {
+    uint32_t k = 0;
+    while (k < 32 && !((w >> k) & 1u))
+      k++;
+    return k;
+  }
+}
+
+template <bool Builtin> uint32_t leadingZeros(uint32_t w) {
+  if constexpr (Builtin) {
+    return sycl::clz(w);
+  } else {
+    uint32_t k = 0;
+    while (k < 32 && !((w >> (31 - k)) & 1u))
+      k++;
+    return k;
+  }
+}
+
+// The rank directory holds the number of set bits before each block
+constexpr uint32_t wordsPerBlock = 16;
+
+// Number of set bits before position `pos`
+template <bool Builtin>
+uint32_t bitRank(const uint32_t *bits, const uint32_t *dir, uint32_t pos) {
+  uint32_t word = pos / 32;
+  uint32_t r = dir[word / wordsPerBlock];
+  for (uint32_t w = word / wordsPerBlock * wordsPerBlock; w < word; w++)
+    r += countOnes<Builtin>(bits[w]);
+  return r + countOnes<Builtin>(bits[word] & ((1u << (pos % 32)) - 1u));
+}
+
+// Position of the set bit with rank `k`, for k less than the total count
+template <bool Builtin>
+uint32_t bitSelect(const uint32_t *bits, const uint32_t *dir,
+                   uint32_t numBlocks, uint32_t k) {
+  // Find the block with dir[lo] <= k < dir[lo + 1]
+  uint32_t lo = 0, hi = numBlocks;
+  while (hi - lo > 1) {
+    uint32_t mid = (lo + hi) / 2;
+    if (dir[mid] <= k)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  k -= dir[lo];
+
+  uint32_t w = lo * wordsPerBlock;
+  for (uint32_t c = countOnes<Builtin>(bits[w]); k >= c;
+       c = countOnes<Builtin>(bits[++w]))
+    k -= c;
+
+  // Clear the k lowest set bits, the wanted bit is then the lowest one
+  uint32_t word = bits[w];
+  for (uint32_t j = 0; j < k; j++)
+    word &= word - 1;
+  return w * 32 + trailingZeros<Builtin>(word);
+}
+
+// Pseudo-random 32-bit value for query `i`
+uint32_t hashIndex(uint32_t i) {
+  uint32_t h = i * 0x9E3779B9u;
+  h ^= sycl::rotate(h, 15u);
+  return h * 0x85EBCA6Bu;
+}
+
+template <bool Builtin> class Cardinality;
+template <bool Builtin> class FirstLast;
+template <bool Builtin> class RankSelect;
+
+const sycl::property_list toIdentity{
+    sycl::property::reduction::initialize_to_identity()};
+
+// |a AND b| and |a OR b|
+template <bool Builtin>
+sycl::event cardinality(sycl::queue &q, const uint32_t *a, const uint32_t *b,
+                        size_t words, uint32_t *andCount, uint32_t *orCount) {
+  return q.parallel_for<Cardinality<Builtin>>(
+      words, sycl::reduction(andCount, sycl::plus<uint32_t>(), toIdentity),
+      sycl::reduction(orCount, sycl::plus<uint32_t>(), toIdentity),
+      [=](sycl::id<1> i, auto &andSum, auto &orSum) {
+        andSum += countOnes<Builtin>(a[i] & b[i]);
+        orSum += countOnes<Builtin>(a[i] | b[i]);
+      });
+}
+
+// Positions of the first and the last set bit
+template <bool Builtin>
+sycl::event firstLast(sycl::queue &q, const uint32_t *bits, size_t words,
+                      uint32_t *first, uint32_t *last) {
+  return q.parallel_for<FirstLast<Builtin>>(
+      words, sycl::reduction(first, sycl::minimum<uint32_t>(), toIdentity),
+      sycl::reduction(last, sycl::maximum<uint32_t>(), toIdentity),
+      [=](sycl::id<1> i, auto &f, auto &l) {
+        uint32_t w = bits[i];
+        uint32_t base = static_cast<uint32_t>(i[0]) * 32;
+        if (w) {
+          f.combine(base + trailingZeros<Builtin>(w));
+          l.combine(base + 31 - leadingZeros<Builtin>(w));
+        }
+      });
+}
+
+// Random rank and select queries. mad_hi maps a 32-bit hash to a range
+// without a division. Every select result is checked by ranking it again.
+template <bool Builtin>
+sycl::event rankSelect(sycl::queue &q, const uint32_t *bits,
+                       const uint32_t *dir, uint32_t numBlocks, uint32_t nbits,
+                       uint32_t total, size_t numQueries, uint32_t *errors) {
+  return q.parallel_for<RankSelect<Builtin>>(
+      numQueries, sycl::reduction(errors, sycl::plus<uint32_t>(), toIdentity),
+      [=](sycl::id<1> i, auto &err) {
+        uint32_t h = hashIndex(static_cast<uint32_t>(i[0]));
+        uint32_t pos = sycl::mad_hi(h, nbits, 0u);
+        uint32_t k = sycl::mad_hi(sycl::rotate(h, 16u), total, 0u);
+        uint32_t r = bitRank<Builtin>(bits, dir, pos);
+        uint32_t s = bitSelect<Builtin>(bits, dir, numBlocks, k);
+        if (r > pos || bitRank<Builtin>(bits, dir, s) != k)
+          err += 1;
+      });
+}
+
+// Best of three profiled runs, after one warm-up run
+template <typename Fn> double bestMs(Fn launch) {
+  launch().wait();
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int r = 0; r < 3; r++) {
+    sycl::event e = launch();
+    e.wait();
+    best = std::min(
+        best,
+        e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+            e.get_profiling_info<
+                sycl::info::event_profiling::command_start>());
+  }
+  return best / 1.0e6;
+}
+
+int main() {
+  constexpr uint32_t words = 1 << 24;
+  constexpr uint32_t nbits = words * 32;
+  constexpr uint32_t numBlocks = words / wordsPerBlock;
+  constexpr size_t numQueries = 1 << 22;
+
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+
+  // `dense` has random words, `sparse` one random bit per word
+  std::mt19937 gen{3};
+  std::vector<uint32_t> dense(words), sparse(words);
+  for (uint32_t i = 0; i < words; i++) {
+    dense[i] = gen();
+    sparse[i] = 1u << (gen() % 32);
+  }
+
+  // Rank directory, built on the host from the dense bitmap
+  std::vector<uint32_t> dir(numBlocks + 1, 0);
+  for (uint32_t b = 0; b < numBlocks; b++) {
+    uint32_t c = 0;
+    for (uint32_t w = 0; w < wordsPerBlock; w++)
+      c += std::bitset<32>(dense[b * wordsPerBlock + w]).count();
+    dir[b + 1] = dir[b] + c;
+  }
+  uint32_t total = dir[numBlocks];
+
+  uint32_t *dDense = sycl::malloc_device<uint32_t>(words, q);
+  uint32_t *dSparse = sycl::malloc_device<uint32_t>(words, q);
+  uint32_t *dDir = sycl::malloc_device<uint32_t>(numBlocks + 1, q);
+  uint32_t *res = sycl::malloc_shared<uint32_t>(6, q);
+  q.copy(dense.data(), dDense, words);
+  q.copy(sparse.data(), dSparse, words);
+  q.copy(dir.data(), dDir, numBlocks + 1);
+  q.wait();
+
+  std::cout << std::left << std::setw(22) << "kernel" << std::right
+            << std::setw(16) << "built-ins (ms)" << std::setw(16)
+            << "bit loops (ms)" << std::setw(10) << "speedup" << "\n";
+  auto report = [](const char *name, double builtinMs, double loopMs) {
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::fixed << std::setprecision(3) << std::setw(16)
+              << builtinMs << std::setw(16) << loopMs << std::setprecision(1)
+              << std::setw(9) << loopMs / builtinMs << "x\n";
+  };
+
+  report("and/or cardinality", bestMs([&]() {
+           return cardinality<true>(q, dDense, dSparse, words, &res[0],
+                                    &res[1]);
+         }),
+         bestMs([&]() {
+           return cardinality<false>(q, dDense, dSparse, words, &res[2],
+                                     &res[3]);
+         }));
+  bool ok = res[0] == res[2] && res[1] == res[3];
+
+  uint32_t andCount = 0, orCount = 0;
+  for (uint32_t i = 0; i < words; i++) {
+    andCount += std::bitset<32>(dense[i] & sparse[i]).count();
+    orCount += std::bitset<32>(dense[i] | sparse[i]).count();
+  }
+  ok = ok && res[0] == andCount && res[1] == orCount;
+
+  report("first/last set bit", bestMs([&]() {
+           return firstLast<true>(q, dSparse, words, &res[0], &res[1]);
+         }),
+         bestMs([&]() {
+           return firstLast<false>(q, dSparse, words, &res[2], &res[3]);
+         }));
+  ok = ok && res[0] == res[2] && res[1] == res[3];
+  auto bitPos = [](uint32_t oneBit) {
+    return std::bitset<32>(oneBit - 1).count();
+  };
+  ok = ok && res[0] == bitPos(sparse[0]) &&
+       res[1] == (words - 1) * 32 + bitPos(sparse[words - 1]);
+
+  report("rank/select queries", bestMs([&]() {
+           return rankSelect<true>(q, dDense, dDir, numBlocks, nbits, total,
+                                   numQueries, &res[4]);
+         }),
+         bestMs([&]() {
+           return rankSelect<false>(q, dDense, dDir, numBlocks, nbits, total,
+                                    numQueries, &res[5]);
+         }));
+  ok = ok && res[4] == 0 && res[5] == 0;
+
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(dDense, q);
+  sycl::free(dSparse, q);
+  sycl::free(dDir, q);
+  sycl::free(res, q);
+  return ok ? 0 : 1;
+}
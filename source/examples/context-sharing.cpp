@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+constexpr size_t n = 1 << 18;
+
+class Work;
+class Part;
+
+// Microseconds since the construction or the previous lap
+class Stopwatch {
+public:
+  double lap() {
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::micro> d = now - last;
+    last = now;
+    return d.count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point last =
+      std::chrono::steady_clock::now();
+};
+
+enum Step {
+  contextStep,
+  queueStep,
+  bundleStep,
+  allocStep,
+  launchStep,
+  numSteps
+};
+const char *stepNames[numSteps] = {"context", "queue", "kernel bundle",
+                                   "USM alloc + free", "first launch"};
+
+// What a service does for one request: make a queue, get the executable
+// kernel bundle, allocate device memory and run the kernel. Adds the time
+// of each step to t.
+void request(const sycl::context &ctx, const sycl::device &dev,
+             Stopwatch &sw, std::vector<double> &t) {
+  sycl::queue q{ctx, dev};
+  t[queueStep] += sw.lap();
+  auto bundle = sycl::get_kernel_bundle<sycl::bundle_state::executable>(
+      ctx, {dev}, {sycl::get_kernel_id<Work>()});
+  t[bundleStep] += sw.lap();
+  float *p = sycl::malloc_device<float>(n, q);
+  t[allocStep] += sw.lap();
+  q.submit([&](sycl::handler &cgh) {
+     cgh.use_kernel_bundle(bundle);
+     cgh.parallel_for<Work>(n, [=](sycl::id<1> i) { p[i] = i[0] * 2.0f; });
+   }).wait();
+  t[launchStep] += sw.lap();
+  sycl::free(p, q);
+  t[allocStep] += sw.lap();
+}
+
+int main() {
+  constexpr int reps = 10;
+  constexpr int numQueues = 4;
+
+  sycl::device dev;
+  sycl::context shared{dev};
+  std::cout << "Device: " << dev.get_info<sycl::info::device::name>() << "\n";
+
+  // Warm up, so one-time costs such as loading the backend are not counted
+  std::vector<double> fresh(numSteps, 0.0), reuse(numSteps, 0.0);
+  {
+    Stopwatch sw;
+    request(sycl::context{dev}, dev, sw, fresh);
+    request(shared, dev, sw, reuse);
+    std::fill(fresh.begin(), fresh.end(), 0.0);
+    std::fill(reuse.begin(), reuse.end(), 0.0);
+  }
+
+  // A new context per request: nothing that belongs to a context, such as
+  // the built kernels and memory pools, carries over between requests
+  for (int r = 0; r < reps; r++) {
+    Stopwatch sw;
+    sycl::context ctx{dev};
+    fresh[contextStep] += sw.lap();
+    request(ctx, dev, sw, fresh);
+  }
+  // One context for all requests
+  for (int r = 0; r < reps; r++) {
+    Stopwatch sw;
+    request(shared, dev, sw, reuse);
+  }
+
+  std::cout << std::left << std::setw(20) << "step" << std::right
+            << std::setw(20) << "new context (us)" << std::setw(22)
+            << "shared context (us)" << "\n";
+  std::cout << std::fixed << std::setprecision(1);
+  double freshTotal = 0, reuseTotal = 0;
+  for (int s = 0; s < numSteps; s++) {
+    freshTotal += fresh[s] / reps;
+    reuseTotal += reuse[s] / reps;
+    std::cout << std::left << std::setw(20) << stepNames[s] << std::right
+              << std::setw(20) << fresh[s] / reps << std::setw(22);
+    if (s == contextStep)
+      std::cout << "-";
+    else
+      std::cout << reuse[s] / reps;
+    std::cout << "\n";
+  }
+  std::cout << std::left << std::setw(20) << "total" << std::right
+            << std::setw(20) << freshTotal << std::setw(22) << reuseTotal
+            << "\n";
+
+  // Queues made from the same context share its kernels and its USM
+  // allocations. Each queue fills part of one allocation.
+  std::vector<sycl::queue> queues;
+  for (int i = 0; i < numQueues; i++)
+    queues.emplace_back(shared, dev);
+  float *data = sycl::malloc_device<float>(n, dev, shared);
+  std::vector<sycl::event> events;
+  for (int i = 0; i < numQueues; i++) {
+    size_t begin = i * n / numQueues, end = (i + 1) * n / numQueues;
+    events.push_back(
+        queues[i].parallel_for<Part>(end - begin, [=](sycl::id<1> j) {
+          size_t k = begin + j[0];
+          data[k] = k * 2.0f;
+        }));
+  }
+  sycl::event::wait(events);
+
+  std::vector<float> result(n);
+  queues[0].copy(data, result.data(), n).wait();
+  bool ok = true;
+  for (size_t i = 0; i < n; i++)
+    ok = ok && result[i] == i * 2.0f;
+  for (const sycl::queue &q : queues)
+    ok = ok && q.get_context() == shared;
+  std::cout << numQueues << " queues share one context and one allocation\n";
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(data, shared);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Elements are loaded and stored `width` at a time. Arithmetic is always
+// done in float, whatever the storage type T is.
+constexpr int width = 8;
+template <typename T> using vec_t = sycl::vec<T, width>;
+using floatN = sycl::vec<float, width>;
+
+template <typename T> class Dot;
+template <typename T> class Axpy;
+template <typename T> class Softmax;
+
+template <typename T> auto globalPtr(T *p) {
+  return sycl::address_space_cast<sycl::access::address_space::global_space,
+                                  sycl::access::decorated::no>(p);
+}
+
+template <typename T>
+sycl::event dot(sycl::queue &q, const T *x, const T *y, float *result,
+                size_t n) {
+  return q.parallel_for<Dot<T>>(
+      sycl::range<1>{n / width},
+      sycl::reduction(result, sycl::plus<float>(),
+                      sycl::property_list{
+                          sycl::property::reduction::initialize_to_identity()}),
+      [=](sycl::id<1> i, auto &sum) {
+        vec_t<T> a, b;
+        a.load(i[0], globalPtr(x));
+        b.load(i[0], globalPtr(y));
+        floatN p = a.template convert<float>() * b.template convert<float>();
+        float s = 0.0f;
+        for (int k = 0; k < width; k++)
+          s += p[k];
+        sum += s;
+      });
+}
+
+// z = a * x + y
+template <typename T>
+sycl::event axpy(sycl::queue &q, float a, const T *x, const T *y, T *z,
+                 size_t n) {
+  return q.parallel_for<Axpy<T>>(n / width, [=](sycl::id<1> i) {
+    vec_t<T> vx, vy;
+    vx.load(i[0], globalPtr(x));
+    vy.load(i[0], globalPtr(y));
+    floatN r = a * vx.template convert<float>() + vy.template convert<float>();
+    r.template convert<T>().store(i[0], globalPtr(z));
+  });
+}
+
+// Softmax of each row, one work-group per row
+template <typename T>
+sycl::event softmax(sycl::queue &q, const T *in, T *out, size_t rows,
+                    size_t cols, size_t wg) {
+  return q.parallel_for<Softmax<T>>(
+      sycl::nd_range<1>{rows * wg, wg}, [=](sycl::nd_item<1> it) {
+        auto g = it.get_group();
+        const T *row = in + g.get_group_id(0) * cols;
+        T *outRow = out + g.get_group_id(0) * cols;
+
+        float m = -std::numeric_limits<float>::infinity();
+        for (size_t c = it.get_local_id(0); c < cols; c += wg)
+          m = sycl::fmax(m, static_cast<float>(row[c]));
+        m = sycl::reduce_over_group(g, m, sycl::maximum<float>());
+
+        float s = 0.0f;
+        for (size_t c = it.get_local_id(0); c < cols; c += wg)
+          s += sycl::exp(static_cast<float>(row[c]) - m);
+        s = sycl::reduce_over_group(g, s, sycl::plus<float>());
+
+        for (size_t c = it.get_local_id(0); c < cols; c += wg)
+          outRow[c] =
+              static_cast<T>(sycl::exp(static_cast<float>(row[c]) - m) / s);
+      });
+}
+
+// Best of three profiled runs, after one warm-up run
+template <typename Fn> double bestSeconds(Fn launch) {
+  launch().wait();
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int r = 0; r < 3; r++) {
+    sycl::event e = launch();
+    e.wait();
+    best = std::min(
+        best,
+        e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+            e.get_profiling_info<
+                sycl::info::event_profiling::command_start>());
+  }
+  return best / 1.0e9;
+}
+
+struct Results {
+  double dotMs, axpyMs, softmaxMs;
+  float dot;
+  std::vector<float> z, sm;
+};
+
+// Runs the three kernels with storage type T on data converted from the
+// float inputs
+template <typename T>
+Results run(sycl::queue &q, const std::vector<float> &x,
+            const std::vector<float> &y, const std::vector<float> &logits,
+            size_t rows, size_t cols) {
+  size_t n = x.size();
+  size_t wg = std::min<size_t>(
+      256, q.get_device().get_info<sycl::info::device::max_work_group_size>());
+
+  std::vector<T> hx(x.begin(), x.end()), hy(y.begin(), y.end());
+  std::vector<T> hl(logits.begin(), logits.end());
+  T *dx = sycl::malloc_device<T>(n, q);
+  T *dy = sycl::malloc_device<T>(n, q);
+  T *dz = sycl::malloc_device<T>(n, q);
+  T *din = sycl::malloc_device<T>(rows * cols, q);
+  T *dout = sycl::malloc_device<T>(rows * cols, q);
+  float *result = sycl::malloc_shared<float>(1, q);
+  q.copy(hx.data(), dx, n);
+  q.copy(hy.data(), dy, n);
+  q.copy(hl.data(), din, rows * cols);
+  q.wait();
+
+  Results r;
+  r.dotMs = 1e3 * bestSeconds([&]() { return dot(q, dx, dy, result, n); });
+  r.axpyMs =
+      1e3 * bestSeconds([&]() { return axpy(q, 2.0f, dx, dy, dz, n); });
+  r.softmaxMs = 1e3 * bestSeconds([&]() {
+    return softmax(q, din, dout, rows, cols, wg);
+  });
+
+  std::vector<T> hz(n), hsm(rows * cols);
+  q.copy(dz, hz.data(), n);
+  q.copy(dout, hsm.data(), rows * cols);
+  q.wait();
+  r.dot = *result;
+  r.z.assign(hz.begin(), hz.end());
+  r.sm.assign(hsm.begin(), hsm.end());
+
+  sycl::free(dx, q);
+  sycl::free(dy, q);
+  sycl::free(dz, q);
+  sycl::free(din, q);
+  sycl::free(dout, q);
+  sycl::free(result, q);
+  return r;
+}
+
+int main() {
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+  if (!q.get_device().has(sycl::aspect::fp16)) {
+    std::cout << "The device does not support sycl::half\n";
+    return 0;
+  }
+
+  constexpr size_t n = 1 << 23;
+  constexpr size_t rows = 2048;
+  constexpr size_t cols = 4096;
+
+  std::mt19937 gen{7};
+  std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+  std::vector<float> x(n), y(n), logits(rows * cols);
+  for (size_t i = 0; i < n; i++) {
+    x[i] = unit(gen);
+    y[i] = unit(gen);
+  }
+  for (float &v : logits)
+    v = 4.0f * unit(gen);
+
+  // Host references in double precision from the original float data
+  double dotRef = 0, dotScale = 0;
+  for (size_t i = 0; i < n; i++) {
+    dotRef += static_cast<double>(x[i]) * y[i];
+    dotScale += std::fabs(static_cast<double>(x[i]) * y[i]);
+  }
+  std::vector<double> smRef(rows * cols);
+  for (size_t r = 0; r < rows; r++) {
+    const float *row = &logits[r * cols];
+    double m = *std::max_element(row, row + cols), s = 0;
+    for (size_t c = 0; c < cols; c++)
+      s += std::exp(row[c] - m);
+    for (size_t c = 0; c < cols; c++)
+      smRef[r * cols + c] = std::exp(row[c] - m) / s;
+  }
+
+  auto f = run<float>(q, x, y, logits, rows, cols);
+  auto h = run<sycl::half>(q, x, y, logits, rows, cols);
+
+  // Error of the dot product relative to the sum of the absolute products,
+  // and maximum absolute error of AXPY and softmax. Small softmax outputs
+  // are subnormal in half, so a relative error would not be meaningful.
+  auto errors = [&](const auto &r) {
+    double axpyErr = 0, smErr = 0;
+    for (size_t i = 0; i < n; i++)
+      axpyErr = std::max(axpyErr, std::fabs(r.z[i] - (2.0 * x[i] + y[i])));
+    for (size_t i = 0; i < rows * cols; i++)
+      smErr = std::max(smErr, std::fabs(r.sm[i] - smRef[i]));
+    return std::vector<double>{std::fabs(r.dot - dotRef) / dotScale, axpyErr,
+                               smErr};
+  };
+  std::vector<double> fe = errors(f), he = errors(h);
+
+  // The kernels are limited by memory bandwidth, so half storage, which
+  // moves half the bytes, should take about half the time
+  std::cout << std::left << std::setw(10) << "kernel" << std::right
+            << std::setw(12) << "float ms" << std::setw(12) << "half ms"
+            << std::setw(10) << "speedup" << std::setw(14) << "float error"
+            << std::setw(14) << "half error" << "\n";
+  auto printRow = [&](const char *name, double fms, double hms, int k) {
+    std::cout << std::left << std::setw(10) << name << std::right
+              << std::fixed << std::setprecision(3) << std::setw(12) << fms
+              << std::setw(12) << hms << std::setprecision(2)
+              << std::setw(10) << fms / hms << std::scientific
+              << std::setw(14) << fe[k] << std::setw(14) << he[k] << "\n";
+  };
+  printRow("dot", f.dotMs, h.dotMs, 0);
+  printRow("axpy", f.axpyMs, h.axpyMs, 1);
+  printRow("softmax", f.softmaxMs, h.softmaxMs, 2);
+
+  // Rounding x and y in [-1, 1] and 2x + y in [-3, 3] to half bounds the
+  // AXPY error by 3 * 2^-12 + 2^-10, about 1.7e-3
+  bool ok = fe[0] < 1e-4 && fe[1] < 1e-6 && fe[2] < 1e-6 && he[0] < 1e-2 &&
+            he[1] < 1.8e-3 && he[2] < 1e-4;
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+  return ok ? 0 : 1;
+}
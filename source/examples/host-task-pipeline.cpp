@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+constexpr size_t chunkBytes = size_t{8} << 20;
+
+// The device work: a 32-bit hash of every word of the file
+uint32_t mix(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h;
+}
+
+class Mix;
+
+// Makes the command depend on stage[k - back], if that command exists
+void after(sycl::handler &cgh, const std::vector<sycl::event> &stage,
+           size_t k, size_t back) {
+  if (k >= back)
+    cgh.depends_on(stage[k - back]);
+}
+
+// Streams the input file through the device in chunks and writes the
+// result to the output file. Every chunk goes through five commands: a
+// host task reads it into pinned host memory, it is copied to the device,
+// a kernel processes it, it is copied back, and a host task writes it.
+// The commands only depend on each other through events, so with several
+// slots of buffers the stages of different chunks overlap. Returns the
+// time in seconds.
+double pipeline(sycl::queue &q, const fs::path &inPath,
+                const fs::path &outPath, size_t slots) {
+  std::ifstream in{inPath, std::ios::binary};
+  std::ofstream out{outPath, std::ios::binary};
+  size_t fileBytes = fs::file_size(inPath);
+  size_t numChunks = (fileBytes + chunkBytes - 1) / chunkBytes;
+
+  struct Slot {
+    uint32_t *in, *dev, *out;
+  };
+  std::vector<Slot> slot(slots);
+  for (Slot &s : slot) {
+    s.in = sycl::malloc_host<uint32_t>(chunkBytes / 4, q);
+    s.dev = sycl::malloc_device<uint32_t>(chunkBytes / 4, q);
+    s.out = sycl::malloc_host<uint32_t>(chunkBytes / 4, q);
+  }
+
+  std::vector<sycl::event> read(numChunks), copyIn(numChunks),
+      kernel(numChunks), copyOut(numChunks), write(numChunks);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < numChunks; k++) {
+    const Slot &s = slot[k % slots];
+    size_t bytes = std::min(chunkBytes, fileBytes - k * chunkBytes);
+
+    // Reads are in file order, and wait until the slot's input buffer has
+    // been copied to the device
+    read[k] = q.submit([&](sycl::handler &cgh) {
+      after(cgh, read, k, 1);
+      after(cgh, copyIn, k, slots);
+      cgh.host_task([&in, p = s.in, bytes]() {
+        in.read(reinterpret_cast<char *>(p), bytes);
+      });
+    });
+    copyIn[k] = q.submit([&](sycl::handler &cgh) {
+      after(cgh, read, k, 0);
+      after(cgh, copyOut, k, slots);
+      cgh.memcpy(s.dev, s.in, bytes);
+    });
+    kernel[k] = q.submit([&](sycl::handler &cgh) {
+      after(cgh, copyIn, k, 0);
+      uint32_t *dev = s.dev;
+      cgh.parallel_for<Mix>(bytes / 4,
+                            [=](sycl::id<1> i) { dev[i] = mix(dev[i]); });
+    });
+    copyOut[k] = q.submit([&](sycl::handler &cgh) {
+      after(cgh, kernel, k, 0);
+      after(cgh, write, k, slots);
+      cgh.memcpy(s.out, s.dev, bytes);
+    });
+    write[k] = q.submit([&](sycl::handler &cgh) {
+      after(cgh, copyOut, k, 0);
+      after(cgh, write, k, 1);
+      cgh.host_task([&out, p = s.out, bytes]() {
+        out.write(reinterpret_cast<const char *>(p), bytes);
+      });
+    });
+  }
+  q.wait();
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+
+  for (Slot &s : slot) {
+    sycl::free(s.in, q);
+    sycl::free(s.dev, q);
+    sycl::free(s.out, q);
+  }
+  return d.count();
+}
+
+// The input file is the first argument. Without one, a 128 MiB file of
+// random data is created in the temporary directory.
+int main(int argc, char *argv[]) {
+  fs::path dir = fs::temp_directory_path();
+  fs::path inPath = argc > 1 ? fs::path{argv[1]} : dir / "pipeline-in.bin";
+  fs::path outPath = dir / "pipeline-out.bin";
+  if (argc <= 1) {
+    std::mt19937 gen{17};
+    std::vector<uint32_t> words(chunkBytes / 4);
+    std::ofstream f{inPath, std::ios::binary};
+    for (int c = 0; c < 16; c++) {
+      for (uint32_t &w : words)
+        w = gen();
+      f.write(reinterpret_cast<const char *>(words.data()), chunkBytes);
+    }
+  }
+  size_t fileBytes = fs::file_size(inPath);
+  if (fileBytes % 4 != 0) {
+    std::cout << "The file size must be a multiple of 4 bytes\n";
+    return 1;
+  }
+
+  sycl::queue q;
+  std::cout << "File: " << (fileBytes >> 20) << " MiB in chunks of "
+            << (chunkBytes >> 20) << " MiB\n";
+
+  // The first run compiles the kernel and loads the file into the cache
+  pipeline(q, inPath, outPath, 1);
+
+  std::cout << std::setw(6) << "slots" << std::setw(10) << "MB/s" << "\n";
+  for (size_t slots : {1, 2, 3}) {
+    double s = pipeline(q, inPath, outPath, slots);
+    std::cout << std::setw(6) << slots << std::fixed << std::setprecision(1)
+              << std::setw(10) << fileBytes / s / 1e6 << "\n";
+  }
+
+  // Check the output of the last run
+  bool ok = fs::file_size(outPath) == fileBytes;
+  std::ifstream in{inPath, std::ios::binary}, out{outPath, std::ios::binary};
+  std::vector<uint32_t> a(chunkBytes / 4), b(chunkBytes / 4);
+  for (size_t done = 0; ok && done < fileBytes; done += chunkBytes) {
+    size_t bytes = std::min(chunkBytes, fileBytes - done);
+    in.read(reinterpret_cast<char *>(a.data()), bytes);
+    out.read(reinterpret_cast<char *>(b.data()), bytes);
+    for (size_t i = 0; i < bytes / 4; i++)
+      ok = ok && b[i] == mix(a[i]);
+  }
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  if (argc <= 1)
+    fs::remove(inPath);
+  fs::remove(outPath);
+  return ok ? 0 : 1;
+}
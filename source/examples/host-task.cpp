@@ -15,20 +15,21 @@ int main() {
 
   sycl::event e;
   for (int i = 1; i < n; i += 2) {
-    e = q.submit([&](sycl::handler &h) {
-      // wait for previous device task
-      e.wait();
+    sycl::event device_event = q.submit([&](sycl::handler &h) {
+      // run after the previous host task
+      h.depends_on(e);
       auto device_task = [=]() { data[i] = data[i - 1] + 1; };
       h.single_task(device_task);
     });
 
-    q.submit([&](sycl::handler &h) {
-      // wait for device task to complete
-      e.wait();
+    e = q.submit([&](sycl::handler &h) {
+      // run after the device task
+      h.depends_on(device_event);
       auto host_task = [=]() { data[i + 1] = data[i] + 1; };
       h.host_task(host_task);
     });
   }
+  q.wait();
   for (int i = 0; i < n; i++)
     std::cout << i << ": " << data[i] << "\n";
 
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <string>
+
+using ExecBundle = sycl::kernel_bundle<sycl::bundle_state::executable>;
+
+class Scale;
+class Offset;
+class Square;
+
+template <typename Fn> double timeMs(Fn f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::milli> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// Compile and link every kernel in the application for all devices of the
+// context. Device images compiled ahead of time have no input state and
+// are already executable.
+ExecBundle buildAll(const sycl::context &ctx) {
+  if (sycl::has_kernel_bundle<sycl::bundle_state::input>(ctx)) {
+    auto input = sycl::get_kernel_bundle<sycl::bundle_state::input>(ctx);
+    auto object = sycl::compile(input);
+    return sycl::link(object);
+  }
+  return sycl::get_kernel_bundle<sycl::bundle_state::executable>(ctx);
+}
+
+// Apply `op` to every element. When `bundle` is given, the kernel is taken
+// from it and the runtime does not need to build anything at submission.
+template <typename KernelName, typename Op>
+sycl::event launch(sycl::queue &q, const ExecBundle *bundle, float *data,
+                   size_t n, Op op) {
+  return q.submit([&](sycl::handler &cgh) {
+    if (bundle)
+      cgh.use_kernel_bundle(*bundle);
+    cgh.parallel_for<KernelName>(n,
+                                 [=](sycl::id<1> i) { data[i] = op(data[i]); });
+  });
+}
+
+// Run with the argument "lazy" to let the runtime build kernels on first
+// submission. Each mode must run in a separate process so that both start
+// without compiled kernels.
+int main(int argc, char *argv[]) {
+  bool lazy = argc > 1 && std::string(argv[1]) == "lazy";
+  constexpr size_t n = 1 << 20;
+
+  // The kernels update data one after the other
+  sycl::queue q{sycl::property::queue::in_order()};
+  float *data = sycl::malloc_device<float>(n, q);
+  q.fill(data, 1.0f, n).wait();
+
+  std::cout << (lazy ? "Mode: lazy build at first submission\n"
+                     : "Mode: build all kernels at startup\n");
+
+  std::optional<ExecBundle> prebuilt;
+  if (!lazy) {
+    double buildMs = timeMs([&]() { prebuilt = buildAll(q.get_context()); });
+    std::cout << "  Startup build: " << buildMs << " ms\n";
+  }
+  const ExecBundle *bundle = prebuilt ? &*prebuilt : nullptr;
+
+  auto runAll = [&]() {
+    launch<Scale>(q, bundle, data, n, [](float x) { return x * 2.0f; });
+    launch<Offset>(q, bundle, data, n, [](float x) { return x + 1.0f; });
+    launch<Square>(q, bundle, data, n, [](float x) { return x * x; });
+    q.wait();
+  };
+
+  double firstMs = timeMs(runAll);
+  double warmMs = timeMs(runAll);
+  std::cout << "  First launch of 3 kernels: " << firstMs << " ms\n";
+  std::cout << "  Second launch of 3 kernels: " << warmMs << " ms\n";
+
+  // ((1 * 2 + 1)^2 * 2 + 1)^2
+  float result;
+  q.copy(data, &result, 1).wait();
+  bool ok = result == 361.0f;
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(data, q);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// A SYCL function object with its second argument bound to a constant, so
+// that sycl::multiplies<float> with 1.5f computes x * 1.5f
+template <typename Op> struct BindSecond {
+  float value;
+  float operator()(float x) const { return Op{}(x, value); }
+};
+
+// A stage of our own, for values in [0, 1]
+struct Smoothstep {
+  float operator()(float x) const { return x * x * (3.0f - 2.0f * x); }
+};
+
+// The stage f followed by the stage g
+template <typename F, typename G> struct Compose {
+  F f;
+  G g;
+  float operator()(float x) const { return g(f(x)); }
+};
+
+// A single function object for a chain of stages
+template <typename F> F compose(F f) { return f; }
+template <typename F, typename G, typename... Rest>
+auto compose(F f, G g, Rest... rest) {
+  return compose(Compose<F, G>{f, g}, rest...);
+}
+
+// One kernel per stage: every stage reads and writes the whole array
+template <typename... Stages>
+sycl::event unfused(sycl::queue &q, const float *in, float *out, size_t n,
+                    Stages... stages) {
+  sycl::event e;
+  const float *src = in;
+  auto pass = [&](auto stage) {
+    e = q.parallel_for(sycl::range<1>{n}, e,
+                       [=](sycl::id<1> i) { out[i] = stage(src[i]); });
+    src = out;
+  };
+  (pass(stages), ...);
+  return e;
+}
+
+// One kernel for the whole chain: every value is read once, goes through
+// all the stages in registers and is written once
+template <typename... Stages>
+sycl::event fused(sycl::queue &q, const float *in, float *out, size_t n,
+                  Stages... stages) {
+  auto chain = compose(stages...);
+  return q.parallel_for(n, [=](sycl::id<1> i) { out[i] = chain(in[i]); });
+}
+
+// The best of three runs of f, in milliseconds, after a warm-up run that
+// also compiles the kernels
+template <typename F> double bestMs(F f) {
+  f();
+  double best = 1e30;
+  for (int r = 0; r < 3; r++) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> d =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, d.count());
+  }
+  return best;
+}
+
+int main() {
+  sycl::queue q;
+
+  // Scale, shift, clamp to [0, 1] and smooth: five stages
+  BindSecond<sycl::multiplies<float>> scale{1.5f};
+  BindSecond<sycl::plus<float>> shift{-0.25f};
+  BindSecond<sycl::maximum<float>> lower{0.0f};
+  BindSecond<sycl::minimum<float>> upper{1.0f};
+  Smoothstep smooth;
+  constexpr int numStages = 5;
+  auto chain = compose(scale, shift, lower, upper, smooth);
+
+  constexpr size_t maxN = size_t{1} << 26;
+  float *in = sycl::malloc_device<float>(maxN, q);
+  float *out = sycl::malloc_device<float>(maxN, q);
+  float *fusedOut = sycl::malloc_device<float>(maxN, q);
+  std::vector<float> x(maxN), a(maxN), b(maxN);
+  for (size_t i = 0; i < maxN; i++)
+    x[i] = (i % 3001) / 1000.0f - 1.0f;
+  q.copy(x.data(), in, maxN).wait();
+
+  std::cout << std::setw(10) << "elements" << std::setw(14) << "unfused MiB"
+            << std::setw(12) << "fused MiB" << std::setw(13) << "unfused ms"
+            << std::setw(11) << "fused ms" << std::setw(10) << "speedup"
+            << "\n";
+  bool ok = true;
+  for (size_t n = size_t{1} << 16; n <= maxN; n <<= 2) {
+    double u = bestMs([&] {
+      unfused(q, in, out, n, scale, shift, lower, upper, smooth).wait();
+    });
+    double f = bestMs([&] {
+      fused(q, in, fusedOut, n, scale, shift, lower, upper, smooth).wait();
+    });
+    // Each pass over the data reads and writes 4 bytes per value
+    double mib = 2.0 * n * sizeof(float) / 1048576.0;
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(14) << numStages * mib << std::setw(12) << mib
+              << std::setprecision(3) << std::setw(13) << u << std::setw(11)
+              << f << std::setprecision(2) << std::setw(10) << u / f << "\n";
+
+    // The compiler may contract a multiply and an add into an fma in the
+    // fused kernel only, so the results can differ in the last bits
+    q.copy(out, a.data(), n);
+    q.copy(fusedOut, b.data(), n);
+    q.wait();
+    for (size_t i = 0; i < n; i++) {
+      float expected = chain(x[i]);
+      ok = ok && std::fabs(a[i] - expected) <= 1e-6f &&
+           std::fabs(b[i] - expected) <= 1e-6f;
+    }
+  }
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(in, q);
+  sycl::free(out, q);
+  sycl::free(fusedOut, q);
+  return ok ? 0 : 1;
+}
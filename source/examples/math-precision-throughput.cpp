@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+enum class Variant { precise, native, half };
+
+const char *variantName(Variant v) {
+  switch (v) {
+  case Variant::precise:
+    return "sycl::";
+  case Variant::native:
+    return "sycl::native::";
+  default:
+    return "sycl::half_precision::";
+  }
+}
+
+// Each function provides its input domain, the largest error the SYCL
+// specification allows for its precise form, the three device forms and a
+// host reference in long double
+
+struct Exp {
+  static constexpr const char *name = "exp";
+  static constexpr double maxUlp = 3.0;
+  static constexpr float xMin = -10.0f, xMax = 10.0f;
+  static constexpr float yMin = 0.0f, yMax = 0.0f;
+  template <Variant V> static float apply(float x, float) {
+    if constexpr (V == Variant::precise)
+      return sycl::exp(x);
+    else if constexpr (V == Variant::native)
+      return sycl::native::exp(x);
+    else
+      return sycl::half_precision::exp(x);
+  }
+  static long double reference(long double x, long double) {
+    return std::exp(x);
+  }
+};
+
+struct Log {
+  static constexpr const char *name = "log";
+  static constexpr double maxUlp = 3.0;
+  static constexpr float xMin = 1e-3f, xMax = 1e3f;
+  static constexpr float yMin = 0.0f, yMax = 0.0f;
+  template <Variant V> static float apply(float x, float) {
+    if constexpr (V == Variant::precise)
+      return sycl::log(x);
+    else if constexpr (V == Variant::native)
+      return sycl::native::log(x);
+    else
+      return sycl::half_precision::log(x);
+  }
+  static long double reference(long double x, long double) {
+    return std::log(x);
+  }
+};
+
+struct Sin {
+  static constexpr const char *name = "sin";
+  static constexpr double maxUlp = 4.0;
+  static constexpr float xMin = -3.14159f, xMax = 3.14159f;
+  static constexpr float yMin = 0.0f, yMax = 0.0f;
+  template <Variant V> static float apply(float x, float) {
+    if constexpr (V == Variant::precise)
+      return sycl::sin(x);
+    else if constexpr (V == Variant::native)
+      return sycl::native::sin(x);
+    else
+      return sycl::half_precision::sin(x);
+  }
+  static long double reference(long double x, long double) {
+    return std::sin(x);
+  }
+};
+
+struct Cos {
+  static constexpr const char *name = "cos";
+  static constexpr double maxUlp = 4.0;
+  static constexpr float xMin = -3.14159f, xMax = 3.14159f;
+  static constexpr float yMin = 0.0f, yMax = 0.0f;
+  template <Variant V> static float apply(float x, float) {
+    if constexpr (V == Variant::precise)
+      return sycl::cos(x);
+    else if constexpr (V == Variant::native)
+      return sycl::native::cos(x);
+    else
+      return sycl::half_precision::cos(x);
+  }
+  static long double reference(long double x, long double) {
+    return std::cos(x);
+  }
+};
+
+struct Rsqrt {
+  static constexpr const char *name = "rsqrt";
+  static constexpr double maxUlp = 2.0;
+  static constexpr float xMin = 1e-3f, xMax = 1e3f;
+  static constexpr float yMin = 0.0f, yMax = 0.0f;
+  template <Variant V> static float apply(float x, float) {
+    if constexpr (V == Variant::precise)
+      return sycl::rsqrt(x);
+    else if constexpr (V == Variant::native)
+      return sycl::native::rsqrt(x);
+    else
+      return sycl::half_precision::rsqrt(x);
+  }
+  static long double reference(long double x, long double) {
+    return 1.0L / std::sqrt(x);
+  }
+};
+
+struct Divide {
+  static constexpr const char *name = "divide";
+  static constexpr double maxUlp = 2.5;
+  static constexpr float xMin = -100.0f, xMax = 100.0f;
+  static constexpr float yMin = 1.0f, yMax = 100.0f;
+  template <Variant V> static float apply(float x, float y) {
+    if constexpr (V == Variant::precise)
+      return x / y;
+    else if constexpr (V == Variant::native)
+      return sycl::native::divide(x, y);
+    else
+      return sycl::half_precision::divide(x, y);
+  }
+  static long double reference(long double x, long double y) { return x / y; }
+};
+
+struct Powr {
+  static constexpr const char *name = "powr";
+  static constexpr double maxUlp = 16.0;
+  static constexpr float xMin = 0.1f, xMax = 10.0f;
+  static constexpr float yMin = -4.0f, yMax = 4.0f;
+  template <Variant V> static float apply(float x, float y) {
+    if constexpr (V == Variant::precise)
+      return sycl::powr(x, y);
+    else if constexpr (V == Variant::native)
+      return sycl::native::powr(x, y);
+    else
+      return sycl::half_precision::powr(x, y);
+  }
+  static long double reference(long double x, long double y) {
+    return std::pow(x, y);
+  }
+};
+
+// Distance from the reference in units in the last place of a float
+double ulpError(float value, long double ref) {
+  int exponent = std::max(std::ilogb(static_cast<float>(ref)), -126);
+  long double ulp = std::ldexp(1.0L, exponent - 23);
+  return static_cast<double>(std::fabs(value - ref) / ulp);
+}
+
+template <typename F, Variant V> class Accuracy;
+template <typename F, Variant V> class Throughput;
+
+constexpr size_t n = 1 << 20;
+constexpr int opsPerItem = 64;
+
+// The half_precision functions must have at least 10 bits of accuracy;
+// the accuracy of the native functions is implementation-defined
+constexpr double halfMaxUlp = 8192.0;
+
+// Returns whether the accuracy is within the bound for the form
+template <typename F, Variant V> bool measure(sycl::queue &q) {
+  std::mt19937 gen{42};
+  std::uniform_real_distribution<float> xDist{F::xMin, F::xMax};
+  std::uniform_real_distribution<float> yDist{F::yMin, F::yMax};
+  std::vector<float> hx(n), hy(n), hout(n);
+  for (size_t i = 0; i < n; i++) {
+    hx[i] = xDist(gen);
+    hy[i] = yDist(gen);
+  }
+
+  float *x = sycl::malloc_device<float>(n, q);
+  float *y = sycl::malloc_device<float>(n, q);
+  float *out = sycl::malloc_device<float>(n, q);
+  q.copy(hx.data(), x, n);
+  q.copy(hy.data(), y, n);
+  q.wait();
+
+  // One result per input, compared with the host reference
+  q.parallel_for<Accuracy<F, V>>(n, [=](sycl::id<1> i) {
+    out[i] = F::template apply<V>(x[i], y[i]);
+  });
+  q.wait();
+  q.copy(out, hout.data(), n).wait();
+  double maxUlp = 0;
+  for (size_t i = 0; i < n; i++)
+    maxUlp = std::max(maxUlp, ulpError(hout[i], F::reference(hx[i], hy[i])));
+
+  // Many calls per work-item. The argument changes slightly on every call so
+  // the compiler cannot hoist the call out of the loop.
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int r = 0; r < 4; r++) {
+    sycl::event e = q.parallel_for<Throughput<F, V>>(n, [=](sycl::id<1> i) {
+      float xi = x[i], yi = y[i], acc = 0.0f;
+      for (int k = 0; k < opsPerItem; k++)
+        acc += F::template apply<V>(xi * (1.0f + k * 1e-6f), yi);
+      out[i] = acc;
+    });
+    e.wait();
+    // The first run is a warm-up
+    if (r > 0)
+      best = std::min(
+          best,
+          e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+              e.get_profiling_info<
+                  sycl::info::event_profiling::command_start>());
+  }
+  double gops = static_cast<double>(n) * opsPerItem / best;
+
+  std::cout << std::left << std::setw(8) << F::name << std::setw(24)
+            << variantName(V) << std::right << std::setw(10) << gops
+            << std::setw(14) << maxUlp << "\n";
+
+  sycl::free(x, q);
+  sycl::free(y, q);
+  sycl::free(out, q);
+  if constexpr (V == Variant::precise)
+    return maxUlp <= F::maxUlp;
+  else if constexpr (V == Variant::half)
+    return maxUlp <= halfMaxUlp;
+  else
+    return true;
+}
+
+template <typename F> bool measureAll(sycl::queue &q) {
+  bool ok = measure<F, Variant::precise>(q);
+  ok = measure<F, Variant::native>(q) && ok;
+  return measure<F, Variant::half>(q) && ok;
+}
+
+int main() {
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+  std::cout << "Device: "
+            << q.get_device().get_info<sycl::info::device::name>() << "\n";
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << std::left << std::setw(8) << "func" << std::setw(24) << "form"
+            << std::right << std::setw(10) << "Gops/s" << std::setw(14)
+            << "max ULP" << "\n";
+  bool ok = measureAll<Exp>(q);
+  ok = measureAll<Log>(q) && ok;
+  ok = measureAll<Sin>(q) && ok;
+  ok = measureAll<Cos>(q) && ok;
+  ok = measureAll<Rsqrt>(q) && ok;
+  ok = measureAll<Divide>(q) && ok;
+  ok = measureAll<Powr>(q) && ok;
+
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// A read-only mapping of a whole file
+struct Mapping {
+  explicit Mapping(const fs::path &path) : bytes{fs::file_size(path)} {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    addr = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (fd >= 0)
+      ::close(fd);
+    if (addr == MAP_FAILED)
+      throw std::runtime_error("Cannot map " + path.string());
+  }
+  Mapping(const Mapping &) = delete;
+  Mapping &operator=(const Mapping &) = delete;
+  ~Mapping() { ::munmap(addr, bytes); }
+
+  const uint32_t *words() const { return static_cast<const uint32_t *>(addr); }
+
+  size_t bytes;
+  void *addr;
+};
+
+// A field of /proc/self/status in bytes, such as VmRSS, the resident set
+// size, and VmHWM, its peak
+size_t status(const std::string &field) {
+  std::ifstream f{"/proc/self/status"};
+  std::string line;
+  while (std::getline(f, line)) {
+    if (line.compare(0, field.size() + 1, field + ":") == 0) {
+      std::istringstream value{line.substr(field.size() + 1)};
+      size_t kb = 0;
+      value >> kb;
+      return kb * 1024;
+    }
+  }
+  return 0;
+}
+
+// Sets the peak resident set size to the current one
+void resetPeak() { std::ofstream{"/proc/self/clear_refs"} << "5"; }
+
+enum class Ingest { readCopy, mapBuffer, mapSystem };
+
+template <Ingest I> class Checksum;
+
+const sycl::property_list toIdentity{
+    sycl::property::reduction::initialize_to_identity()};
+
+// The sum of the words of the file, the same scan for every way of
+// getting the file to the device
+template <Ingest I>
+sycl::event checksum(sycl::queue &q, const uint32_t *words, size_t n,
+                     uint64_t *sum) {
+  return q.parallel_for<Checksum<I>>(
+      n, sycl::reduction(sum, sycl::plus<uint64_t>(), toIdentity),
+      [=](sycl::id<1> i, auto &s) { s += words[i]; });
+}
+
+// read() into a host vector, then copy to a device allocation
+uint64_t readCopy(sycl::queue &q, const fs::path &path, uint64_t *sum) {
+  size_t bytes = fs::file_size(path);
+  size_t n = bytes / sizeof(uint32_t);
+  std::vector<uint32_t> host(n);
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open " + path.string());
+  char *p = reinterpret_cast<char *>(host.data());
+  for (size_t done = 0; done < n * sizeof(uint32_t);) {
+    ssize_t got = ::read(fd, p + done, n * sizeof(uint32_t) - done);
+    if (got <= 0)
+      break;
+    done += got;
+  }
+  ::close(fd);
+
+  uint32_t *words = sycl::malloc_device<uint32_t>(n, q);
+  if (!words)
+    throw std::runtime_error("Cannot allocate device memory for the file");
+  q.copy(host.data(), words, n).wait();
+  checksum<Ingest::readCopy>(q, words, n, sum).wait();
+  sycl::free(words, q);
+  return *sum;
+}
+
+// The mapping wrapped in a buffer. With use_host_ptr the runtime works on
+// the mapped memory itself instead of a host copy of it; a device that
+// shares memory with the host can read it without any copy.
+uint64_t mapBuffer(sycl::queue &q, const fs::path &path, uint64_t *sum) {
+  Mapping m{path};
+  size_t n = m.bytes / sizeof(uint32_t);
+  {
+    sycl::buffer<uint32_t> b{m.words(), sycl::range<1>{n},
+                             sycl::property::buffer::use_host_ptr()};
+    q.submit([&](sycl::handler &cgh) {
+      sycl::accessor words{b, cgh, sycl::read_only};
+      cgh.parallel_for<Checksum<Ingest::mapBuffer>>(
+          n, sycl::reduction(sum, sycl::plus<uint64_t>(), toIdentity),
+          [=](sycl::id<1> i, auto &s) { s += words[i]; });
+    });
+  }
+  q.wait();
+  return *sum;
+}
+
+// The kernel reads the mapping directly. Only for devices that can access
+// any host memory, which have aspect::usm_system_allocations.
+uint64_t mapSystem(sycl::queue &q, const fs::path &path, uint64_t *sum) {
+  Mapping m{path};
+  checksum<Ingest::mapSystem>(q, m.words(), m.bytes / sizeof(uint32_t), sum)
+      .wait();
+  return *sum;
+}
+
+// The input file is the first argument. Without one, a 512 MiB file is
+// created in the temporary directory.
+int main(int argc, char *argv[]) {
+  fs::path path = argc > 1 ? fs::path{argv[1]}
+                           : fs::temp_directory_path() / "ingestion.bin";
+  if (argc <= 1) {
+    std::vector<uint32_t> words(1 << 20);
+    std::ofstream f{path, std::ios::binary};
+    for (uint32_t c = 0; c < 128; c++) {
+      std::iota(words.begin(), words.end(), c << 20);
+      f.write(reinterpret_cast<const char *>(words.data()),
+              words.size() * sizeof(uint32_t));
+    }
+  }
+
+  sycl::queue q;
+  bool system = q.get_device().has(sycl::aspect::usm_system_allocations);
+  uint64_t *sum = sycl::malloc_shared<uint64_t>(1, q);
+
+  struct Case {
+    const char *name;
+    uint64_t (*run)(sycl::queue &, const fs::path &, uint64_t *);
+    bool supported;
+  };
+  const Case cases[] = {{"read() + copy", readCopy, true},
+                        {"mmap + use_host_ptr", mapBuffer, true},
+                        {"mmap + system USM", mapSystem, system}};
+
+  bool ok = true;
+  try {
+    size_t bytes = fs::file_size(path);
+
+    // The expected sum, from a read of the file
+    uint64_t expected = 0;
+    {
+      std::ifstream f{path, std::ios::binary};
+      std::vector<uint32_t> words(1 << 20);
+      while (f.read(reinterpret_cast<char *>(words.data()),
+                    words.size() * sizeof(uint32_t)) ||
+             f.gcount() > 0) {
+        for (size_t i = 0; i < f.gcount() / sizeof(uint32_t); i++)
+          expected += words[i];
+      }
+    }
+
+    // Compile the kernels and bring the file into the page cache, so every
+    // case reads it from memory
+    for (const Case &c : cases)
+      if (c.supported)
+        c.run(q, path, sum);
+
+    std::cout << "File: " << (bytes >> 20) << " MiB\n";
+    std::cout << std::left << std::setw(22) << "ingestion" << std::right
+              << std::setw(20) << "first result (ms)" << std::setw(18)
+              << "peak RSS (MiB)" << "\n";
+    for (const Case &c : cases) {
+      std::cout << std::left << std::setw(22) << c.name << std::right;
+      if (!c.supported) {
+        std::cout << "not supported by the device\n";
+        continue;
+      }
+      resetPeak();
+      size_t before = status("VmRSS");
+      auto start = std::chrono::steady_clock::now();
+      uint64_t result = c.run(q, path, sum);
+      std::chrono::duration<double, std::milli> ms =
+          std::chrono::steady_clock::now() - start;
+      size_t peak = status("VmHWM");
+      ok = ok && result == expected;
+      std::cout << std::fixed << std::setprecision(1) << std::setw(20)
+                << ms.count() << std::setw(18)
+                << (peak > before ? peak - before : 0) / 1048576.0 << "\n";
+    }
+  } catch (const std::runtime_error &e) {
+    std::cout << e.what() << "\n";
+    ok = false;
+  }
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(sum, q);
+  if (argc <= 1)
+    fs::remove(path);
+  return ok ? 0 : 1;
+}
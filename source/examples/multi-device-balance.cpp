@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr int width = 4096, height = 4096;
+constexpr int maxIter = 1024;
+
+// The image is computed in chunks of rows. Rows through the middle of the
+// set take far longer than rows near the edges.
+constexpr int chunkRows = 16;
+constexpr size_t numChunks = height / chunkRows;
+
+// Iterations until z escapes, for pixel (x, y) of the region
+// [-2, 1] x [-1.5, 1.5]
+uint32_t mandelbrot(int x, int y) {
+  float cr = -2.0f + 3.0f * x / width;
+  float ci = -1.5f + 3.0f * y / height;
+  float zr = 0.0f, zi = 0.0f;
+  int k = 0;
+  for (; k < maxIter && zr * zr + zi * zi <= 4.0f; k++) {
+    float t = zr * zr - zi * zi + cr;
+    zi = 2.0f * zr * zi + ci;
+    zr = t;
+  }
+  return k;
+}
+
+class Mandelbrot;
+
+// One in-order queue and one chunk of device memory per device
+struct Worker {
+  sycl::queue q;
+  uint32_t *rows;
+  size_t chunks;
+  double busyMs;
+};
+
+// Computes chunk c on the worker's device and copies it into the image
+void runChunk(Worker &w, size_t c, uint32_t *image) {
+  uint32_t *rows = w.rows;
+  int y0 = static_cast<int>(c) * chunkRows;
+  w.q.parallel_for<Mandelbrot>(
+      sycl::range<2>{chunkRows, width}, [=](sycl::id<2> i) {
+        rows[i[0] * width + i[1]] = mandelbrot(i[1], y0 + i[0]);
+      });
+  w.q.memcpy(image + static_cast<size_t>(y0) * width, rows,
+             chunkRows * width * sizeof(uint32_t))
+      .wait();
+}
+
+// Calls work(d) on one host thread per device d. Returns the wall time in
+// milliseconds.
+template <typename Fn> double runAll(std::vector<Worker> &workers, Fn work) {
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  std::vector<std::thread> threads;
+  for (size_t d = 0; d < workers.size(); d++) {
+    threads.emplace_back([&, d]() {
+      auto begin = clock::now();
+      workers[d].chunks = 0;
+      work(d);
+      std::chrono::duration<double, std::milli> busy = clock::now() - begin;
+      workers[d].busyMs = busy.count();
+    });
+  }
+  for (std::thread &t : threads)
+    t.join();
+  std::chrono::duration<double, std::milli> d = clock::now() - start;
+  return d.count();
+}
+
+int main() {
+  // Every device of every platform. A device that more than one backend
+  // exposes appears once per backend, and its queues share the hardware.
+  std::vector<Worker> workers;
+  for (const sycl::platform &p : sycl::platform::get_platforms()) {
+    for (const sycl::device &d : p.get_devices()) {
+      if (!d.has(sycl::aspect::usm_device_allocations)) {
+        std::cout << "Skipping " << d.get_info<sycl::info::device::name>()
+                  << ": no USM device allocations\n";
+        continue;
+      }
+      try {
+        sycl::queue q{d, sycl::property::queue::in_order()};
+        uint32_t *rows = sycl::malloc_device<uint32_t>(chunkRows * width, q);
+        if (!rows) {
+          std::cout << "Skipping " << d.get_info<sycl::info::device::name>()
+                    << ": allocation failed\n";
+          continue;
+        }
+        workers.push_back({q, rows, 0, 0.0});
+      } catch (const sycl::exception &e) {
+        std::cout << "Skipping " << d.get_info<sycl::info::device::name>()
+                  << ": " << e.what() << "\n";
+      }
+    }
+  }
+  size_t numDevices = workers.size();
+
+  std::vector<uint32_t> staticImage(size_t{width} * height);
+  std::vector<uint32_t> dynamicImage(size_t{width} * height);
+
+  // Compile the kernel for every device before timing
+  for (Worker &w : workers)
+    runChunk(w, 0, staticImage.data());
+
+  // Static partitioning: each device gets an equal, contiguous range of
+  // chunks
+  double staticMs = runAll(workers, [&](size_t d) {
+    for (size_t c = d * numChunks / numDevices;
+         c < (d + 1) * numChunks / numDevices; c++) {
+      runChunk(workers[d], c, staticImage.data());
+      workers[d].chunks++;
+    }
+  });
+  std::vector<Worker> staticRun = workers;
+
+  // Dynamic balancing: each device takes the next chunk from a shared
+  // counter as soon as it finishes the previous one, so faster devices and
+  // devices with lighter chunks take more of them
+  std::atomic<size_t> next{0};
+  double dynamicMs = runAll(workers, [&](size_t d) {
+    for (size_t c; (c = next.fetch_add(1)) < numChunks;) {
+      runChunk(workers[d], c, dynamicImage.data());
+      workers[d].chunks++;
+    }
+  });
+
+  std::cout << std::left << std::setw(28) << "device" << std::right
+            << std::setw(12) << "static %" << std::setw(12) << "busy ms"
+            << std::setw(12) << "dynamic %" << std::setw(12) << "busy ms"
+            << "\n";
+  std::cout << std::fixed << std::setprecision(1);
+  for (size_t d = 0; d < numDevices; d++) {
+    std::string name =
+        workers[d].q.get_device().get_info<sycl::info::device::name>();
+    std::cout << std::left << std::setw(28) << name.substr(0, 26) << std::right
+              << std::setw(12) << 100.0 * staticRun[d].chunks / numChunks
+              << std::setw(12) << staticRun[d].busyMs << std::setw(12)
+              << 100.0 * workers[d].chunks / numChunks << std::setw(12)
+              << workers[d].busyMs << "\n";
+  }
+  double pixels = static_cast<double>(width) * height;
+  std::cout << "Static:  " << staticMs << " ms, " << pixels / staticMs / 1e3
+            << " Mpixels/s\n";
+  std::cout << "Dynamic: " << dynamicMs << " ms, " << pixels / dynamicMs / 1e3
+            << " Mpixels/s\n";
+
+  // Devices may round differently, so a few pixels on the boundary of the
+  // set may differ from the host
+  size_t checked = 0, mismatches = 0;
+  for (int y = 0; y < height; y += 7) {
+    for (int x = 0; x < width; x++) {
+      uint32_t ref = mandelbrot(x, y);
+      mismatches += staticImage[static_cast<size_t>(y) * width + x] != ref;
+      mismatches += dynamicImage[static_cast<size_t>(y) * width + x] != ref;
+      checked += 2;
+    }
+  }
+  bool ok = numDevices > 0 && mismatches <= checked / 1000;
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  for (Worker &w : workers)
+    sycl::free(w.rows, w.q);
+  return ok ? 0 : 1;
+}
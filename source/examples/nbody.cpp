@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Bodies are float4 values: position in xyz and mass in w
+using sycl::float4;
+
+constexpr float softening = 0.01f;
+constexpr float dt = 0.001f;
+
+// Ways to compute 1 / sqrt(r^2 + softening^2). The softening length is
+// stored in d.w, so the geometric functions include it.
+struct InvLength {
+  float operator()(float4 d) const { return 1.0f / sycl::length(d); }
+};
+struct InvFastLength {
+  float operator()(float4 d) const { return 1.0f / sycl::fast_length(d); }
+};
+struct RsqrtDot {
+  float operator()(float4 d) const { return sycl::rsqrt(sycl::dot(d, d)); }
+};
+
+// Acceleration of body i caused by body j
+template <typename InvDist>
+float4 interaction(float4 bi, float4 bj, InvDist invDist) {
+  float4 d = bj - bi;
+  d.w() = softening;
+  float inv = invDist(d);
+  float s = bj.w() * inv * inv * inv;
+  d.w() = 0.0f;
+  return d * s;
+}
+
+template <typename InvDist> class Naive;
+template <typename InvDist> class Tiled;
+
+// Every work-item reads all bodies from global memory
+template <typename InvDist>
+sycl::event accelNaive(sycl::queue &q, const float4 *bodies, float4 *acc,
+                       size_t n) {
+  return q.parallel_for<Naive<InvDist>>(n, [=](sycl::id<1> i) {
+    float4 bi = bodies[i];
+    float4 a{0.0f};
+    for (size_t j = 0; j < n; j++)
+      a += interaction(bi, bodies[j], InvDist{});
+    acc[i] = a;
+  });
+}
+
+// The work-group loads a tile of bodies into local memory, and every
+// work-item of the group reads them from there. n must be a multiple of
+// the tile size.
+template <typename InvDist>
+sycl::event accelTiled(sycl::queue &q, const float4 *bodies, float4 *acc,
+                       size_t n, size_t tile) {
+  return q.submit([&](sycl::handler &cgh) {
+    sycl::local_accessor<float4, 1> cache{tile, cgh};
+    cgh.parallel_for<Tiled<InvDist>>(
+        sycl::nd_range<1>{n, tile}, [=](sycl::nd_item<1> it) {
+          size_t i = it.get_global_id(0);
+          size_t lid = it.get_local_id(0);
+          float4 bi = bodies[i];
+          float4 a{0.0f};
+          for (size_t base = 0; base < n; base += tile) {
+            cache[lid] = bodies[base + lid];
+            sycl::group_barrier(it.get_group());
+            for (size_t j = 0; j < tile; j++)
+              a += interaction(bi, cache[j], InvDist{});
+            sycl::group_barrier(it.get_group());
+          }
+          acc[i] = a;
+        });
+  });
+}
+
+// Best of three profiled runs, after one warm-up run
+template <typename Fn> double bestSeconds(Fn launch) {
+  launch().wait();
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int r = 0; r < 3; r++) {
+    sycl::event e = launch();
+    e.wait();
+    best = std::min(
+        best,
+        e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+            e.get_profiling_info<
+                sycl::info::event_profiling::command_start>());
+  }
+  return best / 1.0e9;
+}
+
+int main() {
+  constexpr size_t n = 16384;
+  constexpr size_t numChecked = 8;
+  constexpr int steps = 4;
+
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+  size_t tile = std::min<size_t>(
+      256, q.get_device().get_info<sycl::info::device::max_work_group_size>());
+
+  std::mt19937 gen{5};
+  std::uniform_real_distribution<float> coord{-1.0f, 1.0f};
+  std::uniform_real_distribution<float> mass{0.5f, 1.0f};
+  std::vector<float4> hostBodies(n);
+  for (float4 &b : hostBodies)
+    b = float4{coord(gen), coord(gen), coord(gen), mass(gen)};
+
+  float4 *bodies = sycl::malloc_device<float4>(n, q);
+  float4 *vel = sycl::malloc_device<float4>(n, q);
+  float4 *acc = sycl::malloc_device<float4>(n, q);
+  q.copy(hostBodies.data(), bodies, n).wait();
+
+  // Initial velocities go around the z axis: the direction is the
+  // normalized cross product of the axis and the position
+  const float4 axis{0.0f, 0.0f, 1.0f, 0.0f};
+  q.parallel_for(n, [=](sycl::id<1> i) {
+     float4 p = bodies[i];
+     p.w() = 0.0f;
+     vel[i] = 0.1f * sycl::normalize(sycl::cross(axis, p));
+   }).wait();
+
+  // Double precision reference for the first bodies
+  std::vector<double> ref(3 * numChecked, 0.0);
+  for (size_t i = 0; i < numChecked; i++) {
+    for (size_t j = 0; j < n; j++) {
+      double d[3], r2 = softening * softening;
+      for (int k = 0; k < 3; k++) {
+        d[k] = static_cast<double>(hostBodies[j][k]) - hostBodies[i][k];
+        r2 += d[k] * d[k];
+      }
+      double s = hostBodies[j].w() / (r2 * std::sqrt(r2));
+      for (int k = 0; k < 3; k++)
+        ref[3 * i + k] += d[k] * s;
+    }
+  }
+
+  std::cout << std::left << std::setw(26) << "variant" << std::right
+            << std::setw(18) << "Ginteractions/s" << std::setw(14)
+            << "max error" << "\n";
+  bool ok = true;
+  auto run = [&](const char *name, float tolerance, auto launch) {
+    double s = bestSeconds(launch);
+    std::vector<float4> result(numChecked);
+    q.copy(acc, result.data(), numChecked).wait();
+    double err = 0;
+    for (size_t i = 0; i < numChecked; i++) {
+      double norm = 0, diff = 0;
+      for (int k = 0; k < 3; k++) {
+        double e = result[i][k] - ref[3 * i + k];
+        norm += ref[3 * i + k] * ref[3 * i + k];
+        diff += e * e;
+      }
+      err = std::max(err, std::sqrt(diff / norm));
+    }
+    ok = ok && err < tolerance;
+    std::cout << std::left << std::setw(26) << name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(18)
+              << n * n / s / 1e9 << std::scientific << std::setprecision(2)
+              << std::setw(14) << err << "\n";
+  };
+
+  run("naive, length", 1e-3f,
+      [&]() { return accelNaive<InvLength>(q, bodies, acc, n); });
+  run("tiled, length", 1e-3f,
+      [&]() { return accelTiled<InvLength>(q, bodies, acc, n, tile); });
+  run("tiled, rsqrt(dot)", 1e-3f,
+      [&]() { return accelTiled<RsqrtDot>(q, bodies, acc, n, tile); });
+  // fast_length has implementation-defined, reduced precision
+  run("tiled, fast_length", 1e-2f,
+      [&]() { return accelTiled<InvFastLength>(q, bodies, acc, n, tile); });
+
+  // A few simulation steps with the tiled kernel
+  double stepSeconds = 0;
+  for (int s = 0; s < steps; s++) {
+    stepSeconds += bestSeconds(
+        [&]() { return accelTiled<RsqrtDot>(q, bodies, acc, n, tile); });
+    q.parallel_for(n, [=](sycl::id<1> i) {
+       vel[i] += acc[i] * dt;
+       float m = bodies[i].w();
+       bodies[i] += vel[i] * dt;
+       bodies[i].w() = m;
+     }).wait();
+  }
+  std::cout << std::defaultfloat << steps << " steps, "
+            << stepSeconds / steps * 1e3 << " ms per force evaluation\n";
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(bodies, q);
+  sycl::free(vel, q);
+  sycl::free(acc, q);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Risk-free interest rate and volatility, the same for all options
+constexpr double rate = 0.02;
+constexpr double volatility = 0.30;
+
+template <typename T> T normalCdf(T x) {
+  return T(0.5) * (T(1) + sycl::erf(x * T(0.70710678118654752)));
+}
+
+// Black-Scholes prices of a European call and put with spot price s,
+// strike k and t years to expiry
+template <typename T> void blackScholes(T s, T k, T t, T &call, T &put) {
+  const T r = T(rate), v = T(volatility);
+  T vSqrtT = v * sycl::sqrt(t);
+  T d1 = (sycl::log(s / k) + (r + T(0.5) * v * v) * t) / vSqrtT;
+  T d2 = d1 - vSqrtT;
+  T discounted = k * sycl::exp(-r * t);
+  call = s * normalCdf(d1) - discounted * normalCdf(d2);
+  put = discounted * normalCdf(-d2) - s * normalCdf(-d1);
+}
+
+// The host reference, in long double
+void referencePrices(double s, double k, double t, double &call,
+                     double &put) {
+  auto cdf = [](long double x) {
+    return 0.5L * std::erfc(-x / std::sqrt(2.0L));
+  };
+  long double r = rate, v = volatility;
+  long double vSqrtT = v * std::sqrt(static_cast<long double>(t));
+  long double d1 = (std::log(static_cast<long double>(s) / k) +
+                    (r + 0.5L * v * v) * t) /
+                   vSqrtT;
+  long double d2 = d1 - vSqrtT;
+  long double discounted = k * std::exp(-r * t);
+  call = static_cast<double>(s * cdf(d1) - discounted * cdf(d2));
+  put = static_cast<double>(discounted * cdf(-d2) - s * cdf(-d1));
+}
+
+// SplitMix64 of the path and the step: independent random bits for every
+// step of every path, without any generator state
+uint64_t randomBits(uint64_t path, uint64_t step) {
+  uint64_t z = path * 0x9E3779B97F4A7C15u + step * 0xD1B54A32D192ED03u;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+  return z ^ (z >> 31);
+}
+
+template <typename T> class ClosedForm;
+template <typename T> class MonteCarlo;
+
+constexpr int steps = 64;
+
+// Simulates `paths` price paths of geometric Brownian motion in `steps`
+// steps and sums the discounted call payoffs and their squares
+template <typename T>
+sycl::event monteCarlo(sycl::queue &q, T s, T k, T t, size_t paths,
+                       T *sums) {
+  const sycl::property_list toIdentity{
+      sycl::property::reduction::initialize_to_identity()};
+  return q.parallel_for<MonteCarlo<T>>(
+      paths, sycl::reduction(sums, sycl::plus<T>(), toIdentity),
+      sycl::reduction(sums + 1, sycl::plus<T>(), toIdentity),
+      [=](sycl::id<1> i, auto &sum, auto &sumSquares) {
+        const T r = T(rate), v = T(volatility);
+        const T dt = t / steps;
+        const T drift = (r - T(0.5) * v * v) * dt;
+        const T diffusion = v * sycl::sqrt(dt);
+        T logPrice = sycl::log(s);
+        // Box-Muller: two normal variates, so two steps, per 64 random bits
+        for (int j = 0; j < steps; j += 2) {
+          uint64_t bits = randomBits(i[0], j);
+          T u0 = T((bits >> 40) + 1) * T(0x1.0p-24);
+          T u1 = T(bits & 0xFFFFFF) * T(0x1.0p-24);
+          T radius = sycl::sqrt(T(-2) * sycl::log(u0));
+          T angle = T(6.28318530717958648) * u1;
+          // The sum of the two variates, for the two steps together
+          T z = radius * (sycl::cos(angle) + sycl::sin(angle));
+          logPrice += T(2) * drift + diffusion * z;
+        }
+        T payoff =
+            sycl::exp(-r * t) * sycl::fmax(sycl::exp(logPrice) - k, T(0));
+        sum += payoff;
+        sumSquares += payoff * payoff;
+      });
+}
+
+// Best of three profiled runs, after one warm-up run
+template <typename Fn> double bestSeconds(Fn launch) {
+  launch().wait();
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int r = 0; r < 3; r++) {
+    sycl::event e = launch();
+    e.wait();
+    best = std::min(
+        best,
+        e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+            e.get_profiling_info<
+                sycl::info::event_profiling::command_start>());
+  }
+  return best / 1.0e9;
+}
+
+constexpr size_t numOptions = 1 << 22;
+constexpr size_t paths = 1 << 20;
+
+struct Options {
+  std::vector<double> spot, strike, years;
+};
+
+template <typename T>
+bool price(sycl::queue &q, const char *precision, const Options &o) {
+  std::vector<T> hs(o.spot.begin(), o.spot.end());
+  std::vector<T> hk(o.strike.begin(), o.strike.end());
+  std::vector<T> ht(o.years.begin(), o.years.end());
+  T *s = sycl::malloc_device<T>(numOptions, q);
+  T *k = sycl::malloc_device<T>(numOptions, q);
+  T *t = sycl::malloc_device<T>(numOptions, q);
+  T *call = sycl::malloc_device<T>(numOptions, q);
+  T *put = sycl::malloc_device<T>(numOptions, q);
+  T *sums = sycl::malloc_shared<T>(2, q);
+  q.copy(hs.data(), s, numOptions);
+  q.copy(hk.data(), k, numOptions);
+  q.copy(ht.data(), t, numOptions);
+  q.wait();
+
+  // Closed form: one option per work-item
+  double closedSeconds = bestSeconds([&]() {
+    return q.parallel_for<ClosedForm<T>>(numOptions, [=](sycl::id<1> i) {
+      blackScholes(s[i], k[i], t[i], call[i], put[i]);
+    });
+  });
+  std::vector<T> hcall(numOptions), hput(numOptions);
+  q.copy(call, hcall.data(), numOptions);
+  q.copy(put, hput.data(), numOptions);
+  q.wait();
+  double maxError = 0;
+  for (size_t i = 0; i < numOptions; i++) {
+    double refCall, refPut;
+    referencePrices(hs[i], hk[i], ht[i], refCall, refPut);
+    maxError = std::max({maxError, std::abs(hcall[i] - refCall),
+                         std::abs(hput[i] - refPut)});
+  }
+
+  // Monte Carlo: one option, one path per work-item
+  const T s0 = 100, k0 = 100, t0 = 1;
+  double mcSeconds =
+      bestSeconds([&]() { return monteCarlo(q, s0, k0, t0, paths, sums); });
+  double mean = static_cast<double>(sums[0]) / paths;
+  double variance = static_cast<double>(sums[1]) / paths - mean * mean;
+  double standardError = std::sqrt(variance / paths);
+  double refCall, refPut;
+  referencePrices(s0, k0, t0, refCall, refPut);
+  double mcError = std::abs(mean - refCall);
+
+  std::cout << std::left << std::setw(10) << precision << std::setw(14)
+            << "closed form" << std::right << std::scientific
+            << std::setprecision(3) << std::setw(12)
+            << numOptions / closedSeconds << std::setw(12) << maxError
+            << "\n";
+  std::cout << std::left << std::setw(10) << precision << std::setw(14)
+            << "Monte Carlo" << std::right << std::setw(12) << 1.0 / mcSeconds
+            << std::setw(12) << mcError << "\n";
+
+  sycl::free(s, q);
+  sycl::free(k, q);
+  sycl::free(t, q);
+  sycl::free(call, q);
+  sycl::free(put, q);
+  sycl::free(sums, q);
+
+  // The closed form error is rounding error. The Monte Carlo price is within
+  // a few standard errors of the exact price; the paths are simulated
+  // exactly, so there is no discretization error.
+  double tolerance = std::is_same_v<T, float> ? 1e-3 : 1e-9;
+  return maxError <= tolerance && mcError <= 4 * standardError;
+}
+
+int main() {
+  std::mt19937 gen{7};
+  std::uniform_real_distribution<double> spot{5.0, 30.0}, strike{1.0, 100.0},
+      years{0.25, 10.0};
+  Options o;
+  for (size_t i = 0; i < numOptions; i++) {
+    o.spot.push_back(spot(gen));
+    o.strike.push_back(strike(gen));
+    o.years.push_back(years(gen));
+  }
+
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+  std::cout << "Device: "
+            << q.get_device().get_info<sycl::info::device::name>() << "\n";
+  std::cout << "Monte Carlo: " << paths << " paths of " << steps
+            << " steps per option\n";
+  std::cout << std::left << std::setw(10) << "precision" << std::setw(14)
+            << "method" << std::right << std::setw(12) << "options/s"
+            << std::setw(12) << "error" << "\n";
+
+  bool ok = price<float>(q, "float", o);
+  if (q.get_device().has(sycl::aspect::fp64))
+    ok = price<double>(q, "double", o) && ok;
+  else
+    std::cout << "The device does not support double precision\n";
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// A file mapped into the address space. A file opened for writing is
+// created with the given size.
+class MappedFile {
+public:
+  explicit MappedFile(const fs::path &path) : bytes{fs::file_size(path)} {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    map(fd, PROT_READ, MAP_PRIVATE);
+    // The file is read once, front to back
+    ::madvise(addr, bytes, MADV_SEQUENTIAL);
+  }
+
+  MappedFile(const fs::path &path, size_t size) : bytes{size} {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0 && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      ::close(fd);
+      fd = -1;
+    }
+    map(fd, PROT_READ | PROT_WRITE, MAP_SHARED);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile() { ::munmap(addr, bytes); }
+
+  template <typename T> T *data() const { return static_cast<T *>(addr); }
+  size_t size() const { return bytes; }
+
+private:
+  void map(int fd, int prot, int flags) {
+    if (fd < 0)
+      throw std::runtime_error("Cannot open the file");
+    addr = ::mmap(nullptr, bytes, prot, flags, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (addr == MAP_FAILED)
+      throw std::runtime_error("Cannot map the file");
+  }
+
+  size_t bytes;
+  void *addr = nullptr;
+};
+
+// The device work for every value
+float transform(float x) {
+  float y = x;
+  for (int k = 0; k < 32; k++)
+    y = sycl::fma(y, 0.999f, x * 0.001f);
+  return y;
+}
+
+class Transform;
+
+// Streams n floats from `in` through `slots` device buffers of `chunk`
+// floats each, and writes the results to `out`. Each chunk is copied in,
+// transformed in place and copied out. A buffer is only refilled after its
+// previous chunk has been copied out, so with three buffers the copy in of
+// one chunk, the kernel of the next and the copy out of the one after
+// that can run at the same time. Returns the time in seconds.
+double stream(sycl::queue &q, const float *in, float *out, size_t n,
+              size_t chunk, size_t slots) {
+  if (chunk == 0)
+    throw std::runtime_error("The memory budget is too small");
+  std::vector<float *> buffers;
+  for (size_t s = 0; s < slots; s++) {
+    buffers.push_back(sycl::malloc_device<float>(chunk, q));
+    if (!buffers.back()) {
+      for (float *b : buffers)
+        sycl::free(b, q);
+      throw std::runtime_error("Cannot allocate the device buffers");
+    }
+  }
+  size_t numChunks = (n + chunk - 1) / chunk;
+  std::vector<sycl::event> copyIn(numChunks), kernel(numChunks),
+      copyOut(numChunks);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < numChunks; k++) {
+    float *b = buffers[k % slots];
+    size_t offset = k * chunk;
+    size_t count = std::min(chunk, n - offset);
+    copyIn[k] = q.submit([&](sycl::handler &cgh) {
+      if (k >= slots)
+        cgh.depends_on(copyOut[k - slots]);
+      cgh.memcpy(b, in + offset, count * sizeof(float));
+    });
+    kernel[k] = q.submit([&](sycl::handler &cgh) {
+      cgh.depends_on(copyIn[k]);
+      cgh.parallel_for<Transform>(
+          count, [=](sycl::id<1> i) { b[i] = transform(b[i]); });
+    });
+    copyOut[k] = q.submit([&](sycl::handler &cgh) {
+      cgh.depends_on(kernel[k]);
+      cgh.memcpy(out + offset, b, count * sizeof(float));
+    });
+  }
+  q.wait();
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+
+  for (float *b : buffers)
+    sycl::free(b, q);
+  return d.count();
+}
+
+// The arguments are a file of floats and the device memory budget in MiB.
+// Without them, a 512 MiB file is created in the temporary directory and
+// the budget is 48 MiB, so the data is streamed through buffers that hold
+// a small part of it.
+int main(int argc, char *argv[]) {
+  fs::path dir = fs::temp_directory_path();
+  fs::path inPath = argc > 1 ? fs::path{argv[1]} : dir / "out-of-core-in.bin";
+  fs::path outPath = dir / "out-of-core-out.bin";
+  long budgetMiB = argc > 2 ? std::atol(argv[2]) : 48;
+  if (budgetMiB <= 0) {
+    std::cout << "The memory budget must be a positive number of MiB\n";
+    return 1;
+  }
+  if (argc <= 1) {
+    std::vector<float> values(1 << 20);
+    std::ofstream f{inPath, std::ios::binary};
+    uint32_t state = 1;
+    for (int c = 0; c < 128; c++) {
+      for (float &v : values) {
+        state = state * 1664525u + 1013904223u;
+        v = (state >> 8) * 0x1.0p-24f;
+      }
+      f.write(reinterpret_cast<const char *>(values.data()),
+              values.size() * sizeof(float));
+    }
+  }
+
+  sycl::queue q;
+  size_t deviceMemory =
+      q.get_device().get_info<sycl::info::device::global_mem_size>();
+  size_t budget =
+      std::min(static_cast<size_t>(budgetMiB), deviceMemory >> 20) << 20;
+  constexpr size_t maxSlots = 3;
+  size_t chunk = budget / maxSlots / sizeof(float);
+
+  bool ok = true;
+  try {
+    MappedFile in{inPath};
+    size_t n = in.size() / sizeof(float);
+    MappedFile out{outPath, n * sizeof(float)};
+    std::cout << "Device memory: " << (deviceMemory >> 20) << " MiB, budget "
+              << (budget >> 20) << " MiB\n";
+    std::cout << "Dataset: " << (in.size() >> 20) << " MiB in "
+              << (n + chunk - 1) / chunk << " chunks of "
+              << (chunk * sizeof(float) >> 20) << " MiB\n";
+
+    // The first run compiles the kernel and brings the file into the page
+    // cache
+    stream(q, in.data<float>(), out.data<float>(), n, chunk, 1);
+
+    std::cout << std::setw(8) << "buffers" << std::setw(10) << "GB/s" << "\n";
+    for (size_t slots = 1; slots <= maxSlots; slots++) {
+      double s =
+          stream(q, in.data<float>(), out.data<float>(), n, chunk, slots);
+      std::cout << std::setw(8) << slots << std::fixed << std::setprecision(2)
+                << std::setw(10) << n * sizeof(float) / s / 1e9 << "\n";
+    }
+
+    // sycl::fma is correctly rounded, so the host computes the same values
+    const float *x = in.data<float>();
+    const float *y = out.data<float>();
+    for (size_t i = 0; i < n; i += 997)
+      ok = ok && y[i] == transform(x[i]);
+    ok = ok && n > 0 && y[n - 1] == transform(x[n - 1]);
+  } catch (const std::runtime_error &e) {
+    std::cout << e.what() << "\n";
+    ok = false;
+  }
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  if (argc <= 1)
+    fs::remove(inPath);
+  fs::remove(outPath);
+  return ok ? 0 : 1;
+}
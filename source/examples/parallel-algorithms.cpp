@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include "parallel-algorithms.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <execution>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// The best of three runs of f, in milliseconds, after a warm-up run that
+// also compiles the kernels
+template <typename F> double bestMs(F f) {
+  f();
+  double best = 1e30;
+  for (int r = 0; r < 3; r++) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> d =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, d.count());
+  }
+  return best;
+}
+
+void report(const char *name, double syclMs, double hostMs, bool same) {
+  std::cout << std::left << std::setw(18) << name << std::right << std::fixed
+            << std::setprecision(2) << std::setw(10) << syclMs << std::setw(16)
+            << hostMs << std::setw(10) << hostMs / syclMs
+            << (same ? "" : "  wrong result") << "\n";
+}
+
+// The size of the data is the first argument
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::atol(argv[1]) : size_t{1} << 24;
+  constexpr auto par = std::execution::par_unseq;
+
+  // Keys with many repeats, so that unique has work to do
+  std::mt19937 gen{17};
+  std::uniform_int_distribution<uint32_t> dist{0, (1u << 20) - 1};
+  std::vector<uint32_t> keys(n);
+  for (uint32_t &k : keys)
+    k = dist(gen);
+  std::vector<uint32_t> hostOut(n), result(n);
+
+  sycl::queue q;
+  uint32_t *in = sycl::malloc_device<uint32_t>(n, q);
+  uint32_t *out = sycl::malloc_device<uint32_t>(n, q);
+  uint64_t *sum = sycl::malloc_shared<uint64_t>(1, q);
+  size_t *count = sycl::malloc_shared<size_t>(1, q);
+  q.copy(keys.data(), in, n).wait();
+
+  auto square = [](uint32_t x) { return uint64_t{x} * x; };
+  auto hash = [](uint32_t x) { return x * 2654435761u; };
+  auto divisible = [](uint32_t x) { return x % 3 == 0; };
+  auto step = [](uint32_t &x) { x = x * 3 + 1; };
+  auto deviceResult = [&](size_t size) {
+    q.copy(out, result.data(), size).wait();
+    return std::equal(result.begin(), result.begin() + size, hostOut.begin());
+  };
+
+  std::cout << "Elements: " << n << "\n";
+  std::cout << std::left << std::setw(18) << "algorithm" << std::right
+            << std::setw(10) << "SYCL ms" << std::setw(16) << "par_unseq ms"
+            << std::setw(10) << "speedup" << "\n";
+  bool ok = true;
+
+  // The timed runs change the data in place, so the results are checked
+  // after one more run from the original keys
+  {
+    q.copy(in, out, n).wait();
+    double d = bestMs([&] { algorithms::for_each_n(q, out, n, step).wait(); });
+    double h = bestMs([&] { std::for_each_n(par, hostOut.begin(), n, step); });
+    q.copy(in, out, n).wait();
+    algorithms::for_each_n(q, out, n, step).wait();
+    hostOut = keys;
+    std::for_each_n(par, hostOut.begin(), n, step);
+    bool same = deviceResult(n);
+    report("for_each_n", d, h, same);
+    ok = ok && same;
+  }
+  {
+    double d =
+        bestMs([&] { algorithms::transform(q, in, n, out, hash).wait(); });
+    double h = bestMs([&] {
+      std::transform(par, keys.begin(), keys.end(), hostOut.begin(), hash);
+    });
+    bool same = deviceResult(n);
+    report("transform", d, h, same);
+    ok = ok && same;
+  }
+  {
+    uint64_t expected = 0;
+    double d = bestMs([&] {
+      algorithms::transform_reduce(q, in, n, sum, uint64_t{0},
+                                   sycl::plus<uint64_t>(), square)
+          .wait();
+    });
+    double h = bestMs([&] {
+      expected = std::transform_reduce(par, keys.begin(), keys.end(),
+                                       uint64_t{0}, std::plus<>(), square);
+    });
+    report("transform_reduce", d, h, *sum == expected);
+    ok = ok && *sum == expected;
+  }
+  {
+    double d = bestMs([&] {
+      algorithms::inclusive_scan(q, in, n, out, sycl::plus<uint32_t>()).wait();
+    });
+    double h = bestMs([&] {
+      std::inclusive_scan(par, keys.begin(), keys.end(), hostOut.begin());
+    });
+    bool same = deviceResult(n);
+    report("inclusive_scan", d, h, same);
+    ok = ok && same;
+  }
+  {
+    double d = bestMs([&] {
+      algorithms::exclusive_scan(q, in, n, out, 7u, sycl::plus<uint32_t>())
+          .wait();
+    });
+    double h = bestMs([&] {
+      std::exclusive_scan(par, keys.begin(), keys.end(), hostOut.begin(), 7u);
+    });
+    bool same = deviceResult(n);
+    report("exclusive_scan", d, h, same);
+    ok = ok && same;
+  }
+  {
+    size_t expected = 0;
+    double d = bestMs([&] {
+      algorithms::copy_if(q, in, n, out, count, divisible).wait();
+    });
+    double h = bestMs([&] {
+      expected = std::copy_if(par, keys.begin(), keys.end(), hostOut.begin(),
+                              divisible) -
+                 hostOut.begin();
+    });
+    bool same = *count == expected && deviceResult(expected);
+    report("copy_if", d, h, same);
+    ok = ok && same;
+  }
+  {
+    // Sorting works in place, so every run starts with a copy of the keys
+    double d = bestMs([&] {
+      sycl::event copied = q.copy(in, out, n);
+      algorithms::sort(q, out, n, std::less<>(), {copied}).wait();
+    });
+    double h = bestMs([&] {
+      std::copy(par, keys.begin(), keys.end(), hostOut.begin());
+      std::sort(par, hostOut.begin(), hostOut.end());
+    });
+    bool same = deviceResult(n);
+    report("sort", d, h, same);
+    ok = ok && same;
+  }
+  {
+    // Of the sorted keys, in out and in hostOut
+    std::vector<uint32_t> sorted = hostOut;
+    uint32_t *unique = sycl::malloc_device<uint32_t>(n, q);
+    size_t expected = 0;
+    double d = bestMs([&] {
+      algorithms::unique(q, out, n, unique, count).wait();
+    });
+    double h = bestMs([&] {
+      expected = std::unique_copy(par, sorted.begin(), sorted.end(),
+                                  hostOut.begin()) -
+                 hostOut.begin();
+    });
+    q.copy(unique, out, n).wait();
+    bool same = *count == expected && deviceResult(expected);
+    report("unique", d, h, same);
+    ok = ok && same;
+    sycl::free(unique, q);
+  }
+
+  // The same algorithms on buffers, with a size that is not a multiple of
+  // the work-group size
+  {
+    size_t m = std::min(n, size_t{100'003});
+    std::vector<uint32_t> data(keys.begin(), keys.begin() + m);
+    std::vector<uint32_t> scanned(m), sorted(m), kept(m, ~0u);
+    size_t keptCount = 0;
+    {
+      sycl::buffer<uint32_t> b{data.data(), sycl::range<1>{m}};
+      sycl::buffer<uint32_t> s{scanned.data(), sycl::range<1>{m}};
+      sycl::buffer<uint32_t> t{sorted.data(), sycl::range<1>{m}};
+      algorithms::inclusive_scan(q, b, m, s, sycl::plus<uint32_t>());
+      algorithms::transform(q, b, m, t, hash);
+      algorithms::sort(q, t, m);
+      sycl::buffer<uint32_t> k{kept.data(), sycl::range<1>{m}};
+      sycl::buffer<size_t> c{&keptCount, sycl::range<1>{1}};
+      algorithms::copy_if(q, b, m, k, c, divisible);
+    }
+    std::vector<uint32_t> expected(m);
+    std::inclusive_scan(data.begin(), data.end(), expected.begin());
+    bool same = scanned == expected;
+    std::transform(data.begin(), data.end(), expected.begin(), hash);
+    std::sort(expected.begin(), expected.end());
+    same = same && sorted == expected;
+    // The elements after the copied ones are left as they were
+    std::fill(expected.begin(), expected.end(), ~0u);
+    auto end =
+        std::copy_if(data.begin(), data.end(), expected.begin(), divisible);
+    same = same && keptCount == size_t(end - expected.begin()) &&
+           kept == expected;
+    std::cout << "Buffers: " << (same ? "same" : "wrong") << " results\n";
+    ok = ok && same;
+  }
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(in, q);
+  sycl::free(out, q);
+  sycl::free(sum, q);
+  sycl::free(count, q);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,355 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+// Parallel algorithms over USM pointers and one-dimensional buffers. Every
+// algorithm submits its kernels to the queue and returns the event of the
+// last command without waiting for it. A pointer must point to USM memory
+// that the device can access, and the algorithm waits for the events in
+// `deps` before it reads it. A buffer is accessed through accessors, so
+// the runtime orders the algorithm after earlier commands on the buffer.
+//
+// The scans and transform_reduce need a binary operation with a known
+// identity, such as sycl::plus or sycl::maximum: the scans use the group
+// scan functions, and transform_reduce a sycl::reduction that is not given
+// an identity.
+namespace algorithms {
+
+namespace detail {
+
+constexpr size_t groupSize = 256;
+
+// The data of a pointer or a buffer inside a command group
+template <typename T> const T *read(sycl::handler &, const T *p) { return p; }
+template <typename T> auto read(sycl::handler &cgh, sycl::buffer<T> b) {
+  return sycl::accessor{b, cgh, sycl::read_only};
+}
+template <typename T> T *write(sycl::handler &, T *p) { return p; }
+template <typename T> auto write(sycl::handler &cgh, sycl::buffer<T> b) {
+  return sycl::accessor{b, cgh, sycl::write_only, sycl::no_init};
+}
+// For outputs of which only a part is written: the rest keeps its contents
+template <typename T> T *writePart(sycl::handler &, T *p) { return p; }
+template <typename T> auto writePart(sycl::handler &cgh, sycl::buffer<T> b) {
+  return sycl::accessor{b, cgh, sycl::write_only};
+}
+template <typename T> T *readWrite(sycl::handler &, T *p) { return p; }
+template <typename T> auto readWrite(sycl::handler &cgh, sycl::buffer<T> b) {
+  return sycl::accessor{b, cgh, sycl::read_write};
+}
+
+template <typename T, typename Op>
+auto reductionOf(sycl::handler &, T *p, Op op) {
+  return sycl::reduction(p, op);
+}
+template <typename T, typename Op>
+auto reductionOf(sycl::handler &cgh, sycl::buffer<T> b, Op op) {
+  return sycl::reduction(b, cgh, op);
+}
+
+// The element type of a pointer or a buffer
+template <typename P> struct ValueType;
+template <typename T> struct ValueType<T *> {
+  using type = std::remove_const_t<T>;
+};
+template <typename T> struct ValueType<sycl::buffer<T>> {
+  using type = T;
+};
+template <typename P> using value_t = typename ValueType<P>::type;
+
+template <typename F>
+sycl::event submit(sycl::queue &q, const std::vector<sycl::event> &deps,
+                   F f) {
+  return q.submit([&](sycl::handler &cgh) {
+    cgh.depends_on(deps);
+    f(cgh);
+  });
+}
+
+// Frees temporary allocations once e has completed, without blocking the
+// caller
+template <typename... T>
+sycl::event freeAfter(sycl::queue &q, sycl::event e, T *...temporaries) {
+  sycl::context ctx = q.get_context();
+  return q.submit([&](sycl::handler &cgh) {
+    cgh.depends_on(e);
+    cgh.host_task([=]() { (sycl::free(temporaries, ctx), ...); });
+  });
+}
+
+// Work-group scans, then a scan of the totals of the groups, then each
+// group adds the total of the groups before it
+template <typename In, typename Out, typename Op, typename T>
+sycl::event scan(sycl::queue &q, In first, size_t n, Out result, Op op,
+                 T init, bool inclusive,
+                 const std::vector<sycl::event> &deps) {
+  if (n == 0)
+    return submit(q, deps, [](sycl::handler &) {});
+  size_t groups = (n + groupSize - 1) / groupSize;
+  sycl::nd_range<1> range{groups * groupSize, groupSize};
+  const T identity = sycl::known_identity_v<Op, T>;
+  T *totals = sycl::malloc_device<T>(groups, q);
+
+  sycl::event e = submit(q, deps, [&](sycl::handler &cgh) {
+    auto in = read(cgh, first);
+    auto out = write(cgh, result);
+    cgh.parallel_for(range, [=](sycl::nd_item<1> it) {
+      size_t i = it.get_global_id(0);
+      T x = i < n ? T(in[i]) : identity;
+      // inclusive is the same for the whole kernel, so every work-item of
+      // the group calls the same group function
+      T y = inclusive ? sycl::inclusive_scan_over_group(it.get_group(), x, op)
+                      : sycl::exclusive_scan_over_group(it.get_group(), x, op);
+      if (i < n)
+        out[i] = y;
+      if (it.get_local_id(0) == groupSize - 1)
+        totals[it.get_group_linear_id()] = inclusive ? y : op(y, x);
+    });
+  });
+  if (groups > 1)
+    e = scan(q, totals, groups, totals, op, identity, true, {e});
+  e = submit(q, {e}, [&](sycl::handler &cgh) {
+    auto out = readWrite(cgh, result);
+    cgh.parallel_for(range, [=](sycl::nd_item<1> it) {
+      size_t g = it.get_group_linear_id();
+      size_t i = it.get_global_id(0);
+      if (i >= n || (inclusive && g == 0))
+        return;
+      T carry = g == 0      ? init
+                : inclusive ? totals[g - 1]
+                            : op(init, totals[g - 1]);
+      out[i] = op(carry, out[i]);
+    });
+  });
+  return freeAfter(q, e, totals);
+}
+
+// Copies the elements for which keep(in, i) is true, in order, and writes
+// their number to count[0]. The position of each element is the exclusive
+// scan of the flags. As with std::copy_if, the elements of result after
+// the copied ones keep their contents.
+template <typename In, typename Out, typename Count, typename Keep>
+sycl::event compact(sycl::queue &q, In first, size_t n, Out result,
+                    Count count, Keep keep,
+                    const std::vector<sycl::event> &deps) {
+  using C = value_t<Count>;
+  if (n == 0) {
+    return submit(q, deps, [&](sycl::handler &cgh) {
+      auto c = writePart(cgh, count);
+      cgh.single_task([=]() { c[0] = C{0}; });
+    });
+  }
+  uint32_t *flags = sycl::malloc_device<uint32_t>(n, q);
+  uint32_t *pos = sycl::malloc_device<uint32_t>(n, q);
+  sycl::event e = submit(q, deps, [&](sycl::handler &cgh) {
+    auto in = read(cgh, first);
+    cgh.parallel_for(n, [=](sycl::id<1> i) { flags[i] = keep(in, i[0]); });
+  });
+  e = scan(q, flags, n, pos, sycl::plus<uint32_t>(), 0u, false, {e});
+  e = submit(q, {e}, [&](sycl::handler &cgh) {
+    auto in = read(cgh, first);
+    auto out = writePart(cgh, result);
+    auto c = writePart(cgh, count);
+    cgh.parallel_for(n, [=](sycl::id<1> i) {
+      if (flags[i])
+        out[pos[i]] = in[i];
+      if (i[0] == n - 1)
+        c[0] = C(pos[i] + flags[i]);
+    });
+  });
+  return freeAfter(q, e, flags, pos);
+}
+
+// Merges the pairs of sorted runs of `width` elements of src into dst.
+// Every element finds its place by a binary search in the other run.
+template <typename Src, typename Dst, typename Compare>
+void mergeRuns(sycl::handler &cgh, Src src, Dst dst, size_t n, size_t width,
+               Compare comp) {
+  cgh.parallel_for(n, [=](sycl::id<1> id) {
+    size_t i = id[0];
+    size_t start = i / (2 * width) * (2 * width);
+    size_t mid = std::min(start + width, n);
+    size_t end = std::min(start + 2 * width, n);
+    auto x = src[i];
+    size_t lo, hi;
+    if (i < mid) {
+      // Before the elements of the second run that are less than x
+      lo = mid;
+      hi = end;
+      while (lo < hi) {
+        size_t m = (lo + hi) / 2;
+        if (comp(src[m], x))
+          lo = m + 1;
+        else
+          hi = m;
+      }
+      dst[i + lo - mid] = x;
+    } else {
+      // After the elements of the first run that are not greater than x,
+      // so equal elements keep their order
+      lo = start;
+      hi = mid;
+      while (lo < hi) {
+        size_t m = (lo + hi) / 2;
+        if (!comp(x, src[m]))
+          lo = m + 1;
+        else
+          hi = m;
+      }
+      dst[i - mid + lo] = x;
+    }
+  });
+}
+
+} // namespace detail
+
+// Calls f(x) on the first n elements
+template <typename Data, typename F>
+sycl::event for_each_n(sycl::queue &q, Data first, size_t n, F f,
+                       const std::vector<sycl::event> &deps = {}) {
+  return detail::submit(q, deps, [&](sycl::handler &cgh) {
+    auto data = detail::readWrite(cgh, first);
+    cgh.parallel_for(n, [=](sycl::id<1> i) { f(data[i]); });
+  });
+}
+
+// result[i] = op(first[i])
+template <typename In, typename Out, typename Op>
+sycl::event transform(sycl::queue &q, In first, size_t n, Out result, Op op,
+                      const std::vector<sycl::event> &deps = {}) {
+  return detail::submit(q, deps, [&](sycl::handler &cgh) {
+    auto in = detail::read(cgh, first);
+    auto out = detail::write(cgh, result);
+    cgh.parallel_for(n, [=](sycl::id<1> i) { out[i] = op(in[i]); });
+  });
+}
+
+// result[0] = init reduced with transform(first[i]) for every i
+template <typename In, typename Result, typename T, typename Reduce,
+          typename Transform>
+sycl::event transform_reduce(sycl::queue &q, In first, size_t n,
+                             Result result, T init, Reduce reduce,
+                             Transform transform,
+                             const std::vector<sycl::event> &deps = {}) {
+  sycl::event e = detail::submit(q, deps, [&](sycl::handler &cgh) {
+    auto r = detail::write(cgh, result);
+    cgh.single_task([=]() { r[0] = init; });
+  });
+  return detail::submit(q, {e}, [&](sycl::handler &cgh) {
+    auto in = detail::read(cgh, first);
+    cgh.parallel_for(n, detail::reductionOf(cgh, result, reduce),
+                     [=](sycl::id<1> i, auto &r) {
+                       r.combine(transform(in[i]));
+                     });
+  });
+}
+
+// result[i] = first[0] op ... op first[i]
+template <typename In, typename Out, typename Op = sycl::plus<>>
+sycl::event inclusive_scan(sycl::queue &q, In first, size_t n, Out result,
+                           Op op = {},
+                           const std::vector<sycl::event> &deps = {}) {
+  using T = detail::value_t<Out>;
+  return detail::scan(q, first, n, result, op, sycl::known_identity_v<Op, T>,
+                      true, deps);
+}
+
+// result[i] = init op first[0] op ... op first[i - 1]
+template <typename In, typename Out, typename T, typename Op = sycl::plus<>>
+sycl::event exclusive_scan(sycl::queue &q, In first, size_t n, Out result,
+                           T init, Op op = {},
+                           const std::vector<sycl::event> &deps = {}) {
+  return detail::scan(q, first, n, result, op, detail::value_t<Out>(init),
+                      false, deps);
+}
+
+// Copies the elements for which pred is true and writes their number to
+// count[0]
+template <typename In, typename Out, typename Count, typename Pred>
+sycl::event copy_if(sycl::queue &q, In first, size_t n, Out result,
+                    Count count, Pred pred,
+                    const std::vector<sycl::event> &deps = {}) {
+  return detail::compact(
+      q, first, n, result, count,
+      [=](auto in, size_t i) { return pred(in[i]); }, deps);
+}
+
+// Copies the first element of every run of equal elements, like
+// std::unique_copy, and writes their number to count[0]
+template <typename In, typename Out, typename Count,
+          typename Equal = std::equal_to<>>
+sycl::event unique(sycl::queue &q, In first, size_t n, Out result,
+                   Count count, Equal equal = {},
+                   const std::vector<sycl::event> &deps = {}) {
+  return detail::compact(
+      q, first, n, result, count,
+      [=](auto in, size_t i) { return i == 0 || !equal(in[i - 1], in[i]); },
+      deps);
+}
+
+// Stable sort. Each work-group sorts a tile of elements by computing the
+// rank of every element in the tile, then sorted runs are merged in pairs
+// until one run is left.
+template <typename Data, typename Compare = std::less<>>
+sycl::event sort(sycl::queue &q, Data data, size_t n, Compare comp = {},
+                 const std::vector<sycl::event> &deps = {}) {
+  using T = detail::value_t<Data>;
+  constexpr size_t tileSize = detail::groupSize;
+  if (n < 2)
+    return detail::submit(q, deps, [](sycl::handler &) {});
+  T *tmp = sycl::malloc_device<T>(n, q);
+  size_t groups = (n + tileSize - 1) / tileSize;
+
+  sycl::event e = detail::submit(q, deps, [&](sycl::handler &cgh) {
+    auto in = detail::read(cgh, data);
+    sycl::local_accessor<T> tile{tileSize, cgh};
+    cgh.parallel_for(
+        sycl::nd_range<1>{groups * tileSize, tileSize},
+        [=](sycl::nd_item<1> it) {
+          size_t l = it.get_local_id(0);
+          size_t base = it.get_group_linear_id() * tileSize;
+          size_t size = std::min(tileSize, n - base);
+          if (l < size)
+            tile[l] = in[base + l];
+          sycl::group_barrier(it.get_group());
+          if (l < size) {
+            T x = tile[l];
+            size_t rank = 0;
+            for (size_t j = 0; j < size; j++)
+              rank += comp(tile[j], x) || (j < l && !comp(x, tile[j]));
+            tmp[base + rank] = x;
+          }
+        });
+  });
+
+  // The runs are in tmp after the tile sort, and change places with every
+  // merge
+  bool inTmp = true;
+  for (size_t width = tileSize; width < n; width *= 2) {
+    e = detail::submit(q, {e}, [&](sycl::handler &cgh) {
+      if (inTmp)
+        detail::mergeRuns(cgh, tmp, detail::write(cgh, data), n, width, comp);
+      else
+        detail::mergeRuns(cgh, detail::read(cgh, data), tmp, n, width, comp);
+    });
+    inTmp = !inTmp;
+  }
+  if (inTmp) {
+    e = detail::submit(q, {e}, [&](sycl::handler &cgh) {
+      auto out = detail::write(cgh, data);
+      cgh.parallel_for(n, [=](sycl::id<1> i) { out[i] = tmp[i]; });
+    });
+  }
+  return detail::freeAfter(q, e, tmp);
+}
+
+} // namespace algorithms
@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// Counter-based random number generator Philox4x32-10. The output is a
+// function of the key and the counter only, so there is no state to keep
+// between calls or to share between work-items: work-item i asks for
+// random numbers (seed, i, n) and always gets the same ones, on any device
+// and on the host.
+class Philox4x32 {
+public:
+  explicit Philox4x32(uint64_t seed)
+      : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)} {}
+
+  // Four random 32-bit words for the stream of `id`, block `counter`
+  sycl::uint4 operator()(uint64_t id, uint64_t counter) const {
+    return generate(sycl::uint4{static_cast<uint32_t>(counter),
+                                static_cast<uint32_t>(counter >> 32),
+                                static_cast<uint32_t>(id),
+                                static_cast<uint32_t>(id >> 32)},
+                    key);
+  }
+
+  static sycl::uint4 generate(sycl::uint4 c, sycl::uint2 k) {
+    for (int r = 0; r < 10; r++) {
+      if (r > 0)
+        k += sycl::uint2{0x9E3779B9u, 0xBB67AE85u};
+      uint64_t p0 = uint64_t{0xD2511F53u} * c[0];
+      uint64_t p1 = uint64_t{0xCD9E8D57u} * c[2];
+      c = sycl::uint4{static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0],
+                      static_cast<uint32_t>(p1),
+                      static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1],
+                      static_cast<uint32_t>(p0)};
+    }
+    return c;
+  }
+
+private:
+  sycl::uint2 key;
+};
+
+// Uniform in [0, 1), from the upper 24 bits, so every value is exact
+sycl::float4 uniform(sycl::uint4 bits) {
+  return (bits >> 8u).convert<float>() * 0x1.0p-24f;
+}
+
+// Standard normal, by the Box-Muller transform of pairs of words
+sycl::float4 normal(sycl::uint4 bits) {
+  // (0, 1], so the logarithm is finite
+  sycl::float4 u = ((bits >> 8u) + 1u).convert<float>() * 0x1.0p-24f;
+  constexpr float twoPi = 6.28318530718f;
+  float r0 = sycl::sqrt(-2.0f * sycl::log(u[0]));
+  float r1 = sycl::sqrt(-2.0f * sycl::log(u[2]));
+  return sycl::float4{r0 * sycl::cos(twoPi * u[1]),
+                      r0 * sycl::sin(twoPi * u[1]),
+                      r1 * sycl::cos(twoPi * u[3]),
+                      r1 * sycl::sin(twoPi * u[3])};
+}
+
+template <typename T> auto globalPtr(T *p) {
+  return sycl::address_space_cast<sycl::access::address_space::global_space,
+                                  sycl::access::decorated::no>(p);
+}
+
+enum class Distribution { uniform, normal };
+
+// Fills four values per work-item. The counter selects a different block
+// of numbers for each call with the same seed.
+template <Distribution D> class RandomFiller {
+public:
+  RandomFiller(float *out, uint64_t seed, uint64_t counter)
+      : out_{out}, rng_{seed}, counter_{counter} {}
+
+  void operator()(sycl::item<1> item) const {
+    size_t i = item.get_linear_id();
+    sycl::uint4 bits = rng_(i, counter_);
+    sycl::float4 v = D == Distribution::uniform ? uniform(bits) : normal(bits);
+    v.store(i, globalPtr(out_));
+  }
+
+private:
+  float *out_;
+  Philox4x32 rng_;
+  uint64_t counter_;
+};
+
+// Best of three profiled runs, after one warm-up run
+template <typename Fn> double bestSeconds(Fn launch) {
+  launch().wait();
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int r = 0; r < 3; r++) {
+    sycl::event e = launch();
+    e.wait();
+    best = std::min(
+        best,
+        e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+            e.get_profiling_info<
+                sycl::info::event_profiling::command_start>());
+  }
+  return best / 1.0e9;
+}
+
+int main() {
+  constexpr size_t items = 1 << 24;
+  constexpr size_t n = 4 * items;
+  constexpr uint64_t seed = 0x243F6A8885A308D3;
+  constexpr uint64_t counter = 7;
+
+  // Known answers of the reference implementation of Philox4x32-10
+  bool ok = Philox4x32::generate(sycl::uint4{0u, 0u, 0u, 0u},
+                                 sycl::uint2{0u, 0u})[0] == 0x6627E8D5u &&
+            Philox4x32::generate(sycl::uint4{0x243F6A88u, 0x85A308D3u,
+                                             0x13198A2Eu, 0x03707344u},
+                                 sycl::uint2{0xA4093822u, 0x299F31D0u})[3] ==
+                0x24126EA1u;
+
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+  float *uniforms = sycl::malloc_device<float>(n, q);
+  float *normals = sycl::malloc_device<float>(n, q);
+
+  auto fill = [&](auto filler) {
+    return bestSeconds([&]() {
+      return q.submit([&](sycl::handler &cgh) {
+        cgh.parallel_for(sycl::range<1>{items}, filler);
+      });
+    });
+  };
+  double uniformSeconds =
+      fill(RandomFiller<Distribution::uniform>{uniforms, seed, counter});
+  double normalSeconds =
+      fill(RandomFiller<Distribution::normal>{normals, seed, counter});
+
+  std::cout << std::left << std::setw(12) << "numbers" << std::right
+            << std::setw(14) << "Gnumbers/s" << "\n";
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << std::left << std::setw(12) << "uniform" << std::right
+            << std::setw(14) << n / uniformSeconds / 1e9 << "\n";
+  std::cout << std::left << std::setw(12) << "normal" << std::right
+            << std::setw(14) << n / normalSeconds / 1e9 << "\n";
+
+  // The host generates the same numbers. The uniform values are exact; the
+  // normal values may differ in the last bits of the device's log, sin and
+  // cos, so they are compared with a double-precision transform.
+  std::vector<float> u(n), z(n);
+  q.copy(uniforms, u.data(), n);
+  q.copy(normals, z.data(), n);
+  q.wait();
+  Philox4x32 rng{seed};
+  const double twoPi = 2.0 * std::acos(-1.0);
+  double sum = 0, sumSquares = 0;
+  for (size_t i = 0; i < items; i++) {
+    sycl::uint4 bits = rng(i, counter);
+    sycl::float4 expected = uniform(bits);
+    for (int k = 0; k < 4; k++)
+      ok = ok && u[4 * i + k] == expected[k];
+    for (int k = 0; k < 4; k += 2) {
+      double u0 = ((bits[k] >> 8) + 1) * 0x1.0p-24;
+      double u1 = ((bits[k + 1] >> 8) + 1) * 0x1.0p-24;
+      double r = std::sqrt(-2.0 * std::log(u0));
+      double ref[2] = {r * std::cos(twoPi * u1),
+                       r * std::sin(twoPi * u1)};
+      for (int j = 0; j < 2; j++) {
+        float v = z[4 * i + k + j];
+        ok = ok && std::abs(v - ref[j]) <= 1e-4 * (1.0 + std::abs(ref[j]));
+        sum += v;
+        sumSquares += double{v} * v;
+      }
+    }
+  }
+  double mean = sum / n;
+  double variance = sumSquares / n - mean * mean;
+  std::cout << std::setprecision(4) << "Normal mean " << mean << ", variance "
+            << variance << "\n";
+  ok = ok && std::abs(mean) < 1e-3 && std::abs(variance - 1.0) < 1e-3;
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(uniforms, q);
+  sycl::free(normals, q);
+  return ok ? 0 : 1;
+}
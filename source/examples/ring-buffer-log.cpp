@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Binary log record written by a work-item
+struct LogRecord {
+  uint32_t batch;
+  uint32_t item;
+  uint32_t tag;
+  float value;
+};
+
+constexpr uint32_t capacity = 1 << 17;
+constexpr int numSegments = 3;
+
+// One segment of the ring. `cursor` counts the appended records, including
+// the ones dropped because the segment was full.
+struct LogSegment {
+  uint32_t cursor;
+  LogRecord records[capacity];
+};
+
+// Appends a record with one atomic increment and one store
+void append(LogSegment *seg, const LogRecord &r) {
+  sycl::atomic_ref<uint32_t, sycl::memory_order::relaxed,
+                   sycl::memory_scope::device,
+                   sycl::access::address_space::global_space>
+      cursor{seg->cursor};
+  uint32_t slot = cursor.fetch_add(1u);
+  if (slot < capacity)
+    seg->records[slot] = r;
+}
+
+// Some work for every work-item
+float work(size_t i) {
+  float x = i * 1e-6f;
+  for (int k = 0; k < 64; k++)
+    x = sycl::sin(x) + 0.5f;
+  return x;
+}
+
+// Whether work-item i logs, for a log rate of 1 / period
+bool shouldLog(uint32_t i, uint32_t period) {
+  uint32_t h = i * 0x9E3779B9u;
+  return (h ^ (h >> 16)) % period == 0;
+}
+
+class NoLog;
+class RingLog;
+class StreamLog;
+
+// Batch b logs into segment b % numSegments. A host thread drains each
+// segment after its batch completes, while the next batches run. A
+// segment is reused once its earlier drain has finished. The segments are
+// separate allocations, so the host never touches memory that a running
+// kernel uses.
+class RingLogger {
+public:
+  explicit RingLogger(sycl::queue &q) : q{q} {
+    for (int s = 0; s < numSegments; s++) {
+      ring[s] = sycl::malloc_shared<LogSegment>(1, q);
+      ring[s]->cursor = 0;
+    }
+  }
+  ~RingLogger() {
+    finish();
+    for (LogSegment *seg : ring)
+      sycl::free(seg, q);
+  }
+
+  template <typename Fn> void run(uint32_t batch, Fn kernel) {
+    int s = batch % numSegments;
+    if (drains[s].valid())
+      drains[s].get();
+    sycl::event e = kernel(ring[s]);
+    drains[s] = std::async(std::launch::async, [this, s, e]() mutable {
+      e.wait();
+      drain(*ring[s]);
+    });
+  }
+
+  void finish() {
+    for (std::future<void> &d : drains)
+      if (d.valid())
+        d.get();
+  }
+
+  std::vector<LogRecord> records;
+  uint64_t dropped = 0;
+
+private:
+  void drain(LogSegment &seg) {
+    uint32_t count = std::min(seg.cursor, capacity);
+    std::lock_guard<std::mutex> lock{mutex};
+    records.insert(records.end(), seg.records, seg.records + count);
+    dropped += seg.cursor - count;
+    seg.cursor = 0;
+  }
+
+  sycl::queue &q;
+  LogSegment *ring[numSegments];
+  std::future<void> drains[numSegments];
+  std::mutex mutex;
+};
+
+// Sends stdout to /dev/null while it is alive, so that the sycl::stream
+// output does not mix with the results
+class DiscardStdout {
+public:
+  DiscardStdout() : saved{dup(STDOUT_FILENO)} {
+    std::fflush(stdout);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+  }
+  ~DiscardStdout() {
+    std::fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+  }
+
+private:
+  int saved;
+};
+
+template <typename Fn> double timeMs(Fn f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::milli> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+int main() {
+  constexpr size_t n = 1 << 20;
+  constexpr uint32_t batches = 16;
+  constexpr uint32_t tag = 7;
+
+  sycl::queue q;
+  float *result = sycl::malloc_device<float>(n, q);
+
+  auto noLog = [&](uint32_t) {
+    return q.parallel_for<NoLog>(
+        n, [=](sycl::id<1> i) { result[i] = work(i); });
+  };
+  auto ringLog = [&](uint32_t batch, uint32_t period, LogSegment *seg) {
+    return q.parallel_for<RingLog>(n, [=](sycl::id<1> i) {
+      float v = work(i);
+      result[i] = v;
+      uint32_t item = static_cast<uint32_t>(i[0]);
+      if (shouldLog(item, period))
+        append(seg, LogRecord{batch, item, tag, v});
+    });
+  };
+  // The stream buffer must be large enough for all the output of a batch
+  auto streamLog = [&](uint32_t batch, uint32_t period) {
+    return q.submit([&](sycl::handler &cgh) {
+      sycl::stream out{64 * (n / period) + 1024, 128, cgh};
+      cgh.parallel_for<StreamLog>(n, [=](sycl::id<1> i) {
+        float v = work(i);
+        result[i] = v;
+        uint32_t item = static_cast<uint32_t>(i[0]);
+        if (shouldLog(item, period))
+          out << "batch " << batch << " item " << item << " tag " << tag
+              << " value " << v << sycl::endl;
+      });
+    });
+  };
+
+  // Warm up all three kernels
+  noLog(0).wait();
+  {
+    RingLogger warmUp{q};
+    warmUp.run(0, [&](LogSegment *seg) { return ringLog(0, 4096, seg); });
+  }
+  {
+    DiscardStdout discard;
+    streamLog(0, 4096).wait();
+  }
+
+  double baseMs = timeMs([&]() {
+                    for (uint32_t b = 0; b < batches; b++)
+                      noLog(b);
+                    q.wait();
+                  }) /
+                  batches;
+  std::cout << "Without logging: " << std::fixed << std::setprecision(2)
+            << baseMs << " ms per batch\n";
+  std::cout << std::right << std::setw(10) << "log rate" << std::setw(16)
+            << "records/batch" << std::setw(12) << "ring (ms)" << std::setw(14)
+            << "stream (ms)" << "\n";
+
+  bool ok = true;
+  for (uint32_t period : {4096u, 256u, 16u}) {
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < n; i++)
+      expected += shouldLog(i, period);
+
+    RingLogger logger{q};
+    double ringMs = timeMs([&]() {
+                      for (uint32_t b = 0; b < batches; b++)
+                        logger.run(b, [&](LogSegment *seg) {
+                          return ringLog(b, period, seg);
+                        });
+                      logger.finish();
+                    }) /
+                    batches;
+
+    // Every logging work-item of every batch must be in the log once
+    std::vector<uint32_t> perBatch(batches, 0);
+    for (const LogRecord &r : logger.records) {
+      if (r.batch >= batches || r.tag != tag || !shouldLog(r.item, period)) {
+        ok = false;
+        break;
+      }
+      perBatch[r.batch]++;
+    }
+    for (uint32_t count : perBatch)
+      ok = ok && count == expected;
+    ok = ok && logger.dropped == 0;
+
+    double streamMs;
+    {
+      DiscardStdout discard;
+      streamMs = timeMs([&]() {
+                   for (uint32_t b = 0; b < batches; b++)
+                     streamLog(b, period);
+                   q.wait();
+                 }) /
+                 batches;
+    }
+
+    std::cout << std::setw(10) << ("1/" + std::to_string(period))
+              << std::setw(16) << expected << std::setw(12) << ringMs
+              << std::setw(14) << streamMs << "\n";
+  }
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(result, q);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using coeff_t = std::array<std::array<float, 3>, 3>;
+using ExecBundle = sycl::kernel_bundle<sycl::bundle_state::executable>;
+
+constexpr sycl::specialization_id<coeff_t> coeff_id;
+
+class ConvSpec;
+class ConvArgs;
+
+template <typename Fn> double timeMs(Fn f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::milli> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// One member of the family of filters the application uses
+coeff_t makeCoefficients(int k) {
+  coeff_t c;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++)
+      c[i][j] = static_cast<float>((k + 3 * i + j) % 5) - 2.0f;
+  return c;
+}
+
+// 3x3 convolution of a row-major image, zero outside the borders
+float convolve(const float *in, size_t rows, size_t cols, sycl::id<2> idx,
+               const coeff_t &coeff) {
+  float acc = 0;
+  for (int i = -1; i <= 1; i++) {
+    long r = static_cast<long>(idx[0]) + i;
+    if (r < 0 || r >= static_cast<long>(rows))
+      continue;
+    for (int j = -1; j <= 1; j++) {
+      long c = static_cast<long>(idx[1]) + j;
+      if (c < 0 || c >= static_cast<long>(cols))
+        continue;
+      acc += coeff[i + 1][j + 1] * in[r * cols + c];
+    }
+  }
+  return acc;
+}
+
+// Executable bundles of the ConvSpec kernel, one per coefficient set. Each
+// bundle is built once with its specialization constant already set, so
+// submissions that use it never trigger a build.
+class VariantCache {
+public:
+  VariantCache(const sycl::context &ctx, const sycl::device &dev)
+      : ctx_{ctx}, dev_{dev} {}
+
+  const ExecBundle &get(const coeff_t &coeff) {
+    auto it = cache_.find(coeff);
+    if (it == cache_.end()) {
+      auto input = sycl::get_kernel_bundle<sycl::bundle_state::input>(
+          ctx_, {dev_}, {sycl::get_kernel_id<ConvSpec>()});
+      input.set_specialization_constant<coeff_id>(coeff);
+      it = cache_.emplace(coeff, sycl::build(input)).first;
+    }
+    return it->second;
+  }
+
+private:
+  sycl::context ctx_;
+  sycl::device dev_;
+  std::map<coeff_t, ExecBundle> cache_;
+};
+
+// Convolution with the coefficients as a specialization constant. The
+// constant comes from `bundle` when given, otherwise it is set on the
+// handler for this submission.
+sycl::event convSpec(sycl::queue &q, const ExecBundle *bundle,
+                     const coeff_t &coeff, const float *in, float *out,
+                     size_t rows, size_t cols) {
+  return q.submit([&](sycl::handler &cgh) {
+    if (bundle)
+      cgh.use_kernel_bundle(*bundle);
+    else
+      cgh.set_specialization_constant<coeff_id>(coeff);
+    cgh.parallel_for<ConvSpec>(
+        sycl::range<2>{rows, cols},
+        [=](sycl::item<2> item, sycl::kernel_handler h) {
+          coeff_t c = h.get_specialization_constant<coeff_id>();
+          out[item.get_linear_id()] =
+              convolve(in, rows, cols, item.get_id(), c);
+        });
+  });
+}
+
+// Fallback: the coefficients are an ordinary kernel argument
+sycl::event convArgs(sycl::queue &q, const coeff_t &coeff, const float *in,
+                     float *out, size_t rows, size_t cols) {
+  return q.parallel_for<ConvArgs>(
+      sycl::range<2>{rows, cols}, [=](sycl::item<2> item) {
+        out[item.get_linear_id()] =
+            convolve(in, rows, cols, item.get_id(), coeff);
+      });
+}
+
+int main() {
+  constexpr size_t rows = 512;
+  constexpr size_t cols = 512;
+  constexpr int numSets = 8;
+  constexpr int rounds = 20;
+
+  sycl::queue q;
+  float *in = sycl::malloc_device<float>(rows * cols, q);
+  float *outSpec = sycl::malloc_device<float>(rows * cols, q);
+  float *outArgs = sycl::malloc_device<float>(rows * cols, q);
+  q.parallel_for(rows * cols,
+                 [=](sycl::id<1> i) { in[i] = static_cast<float>(i % 7); });
+  q.wait();
+
+  std::vector<coeff_t> family;
+  for (int k = 0; k < numSets; k++)
+    family.push_back(makeCoefficients(k));
+
+  // Time one pass over the family, then the average launch of later passes
+  auto measure = [&](const char *name, auto launch) {
+    double firstMs = timeMs([&]() {
+      for (const coeff_t &c : family)
+        launch(c).wait();
+    });
+    double steadyMs = timeMs([&]() {
+      for (int r = 0; r < rounds; r++)
+        for (const coeff_t &c : family)
+          launch(c).wait();
+    });
+    std::cout << std::left << std::setw(24) << name << std::right
+              << std::setw(16) << firstMs << std::setw(20)
+              << steadyMs * 1000.0 / (rounds * numSets) << "\n";
+  };
+
+  bool canSpecialize = sycl::has_kernel_bundle<sycl::bundle_state::input>(
+      q.get_context(), {q.get_device()}, {sycl::get_kernel_id<ConvSpec>()});
+  VariantCache cache{q.get_context(), q.get_device()};
+
+  std::cout << std::fixed << std::setprecision(2);
+  if (canSpecialize) {
+    double buildMs = timeMs([&]() {
+      for (const coeff_t &c : family)
+        cache.get(c);
+    });
+    std::cout << "Pre-built " << numSets << " variants in " << buildMs
+              << " ms\n";
+  } else {
+    std::cout << "No input bundle for ConvSpec, "
+              << "only the kernel argument path is used\n";
+  }
+
+  std::cout << std::left << std::setw(24) << "Path" << std::right
+            << std::setw(16) << "first pass (ms)" << std::setw(20)
+            << "launch (us)" << "\n";
+  // The last filter of the family from each path
+  std::vector<float> cached(rows * cols), spec(rows * cols),
+      args(rows * cols);
+  if (canSpecialize) {
+    measure("cached bundles", [&](const coeff_t &c) {
+      return convSpec(q, &cache.get(c), c, in, outSpec, rows, cols);
+    });
+    q.copy(outSpec, cached.data(), rows * cols).wait();
+    measure("handler spec constant", [&](const coeff_t &c) {
+      return convSpec(q, nullptr, c, in, outSpec, rows, cols);
+    });
+  }
+  measure("kernel arguments", [&](const coeff_t &c) {
+    return convArgs(q, c, in, outArgs, rows, cols);
+  });
+
+  if (canSpecialize)
+    q.copy(outSpec, spec.data(), rows * cols);
+  q.copy(outArgs, args.data(), rows * cols);
+  q.wait();
+  bool ok = true;
+  for (size_t i = 0; canSpecialize && i < rows * cols; i++)
+    if (std::fabs(cached[i] - args[i]) > 1e-4f * (1 + std::fabs(args[i])) ||
+        std::fabs(spec[i] - args[i]) > 1e-4f * (1 + std::fabs(args[i])))
+      ok = false;
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(in, q);
+  sycl::free(outSpec, q);
+  sycl::free(outArgs, q);
+  return ok ? 0 : 1;
+}
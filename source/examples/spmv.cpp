@@ -0,0 +1,333 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// A sparse matrix in compressed sparse row format. The nonzeros of row r
+// are val[rowPtr[r]] to val[rowPtr[r + 1] - 1], in columns col[...].
+struct Csr {
+  size_t rows = 0, cols = 0;
+  std::vector<uint32_t> rowPtr, col;
+  std::vector<float> val;
+};
+
+struct Triplet {
+  uint32_t row, col;
+  float val;
+};
+
+Csr fromTriplets(size_t rows, size_t cols, const std::vector<Triplet> &t) {
+  Csr a;
+  a.rows = rows;
+  a.cols = cols;
+  a.rowPtr.assign(rows + 1, 0);
+  for (const Triplet &e : t)
+    a.rowPtr[e.row + 1]++;
+  for (size_t r = 0; r < rows; r++)
+    a.rowPtr[r + 1] += a.rowPtr[r];
+  std::vector<uint32_t> next(a.rowPtr.begin(), a.rowPtr.end() - 1);
+  a.col.resize(t.size());
+  a.val.resize(t.size());
+  for (const Triplet &e : t) {
+    a.col[next[e.row]] = e.col;
+    a.val[next[e.row]++] = e.val;
+  }
+  return a;
+}
+
+// Reads a real, integer or pattern matrix in Matrix Market coordinate
+// format. Symmetric matrices are expanded to both triangles.
+Csr readMatrixMarket(const std::string &path) {
+  std::ifstream f{path};
+  std::string line;
+  if (!std::getline(f, line))
+    throw std::runtime_error("Cannot read " + path);
+  for (char &c : line)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  std::istringstream banner{line};
+  std::string magic, object, format, field, symmetry;
+  banner >> magic >> object >> format >> field >> symmetry;
+  if (magic != "%%matrixmarket" || object != "matrix" ||
+      format != "coordinate" || field == "complex")
+    throw std::runtime_error(path + " is not a real coordinate matrix");
+  bool pattern = field == "pattern";
+  bool symmetric = symmetry == "symmetric" || symmetry == "skew-symmetric";
+  float mirror = symmetry == "skew-symmetric" ? -1.0f : 1.0f;
+
+  while (std::getline(f, line) && line[0] == '%') {
+  }
+  size_t rows, cols, entries;
+  std::istringstream{line} >> rows >> cols >> entries;
+  std::vector<Triplet> t;
+  for (size_t k = 0; k < entries; k++) {
+    uint32_t r, c;
+    float v = 1.0f;
+    if (!(f >> r >> c) || (!pattern && !(f >> v)))
+      throw std::runtime_error(path + " ends early");
+    t.push_back({r - 1, c - 1, v});
+    if (symmetric && r != c)
+      t.push_back({c - 1, r - 1, mirror * v});
+  }
+  return fromTriplets(rows, cols, t);
+}
+
+// A square matrix with random columns and values. Each row gets
+// rowLength() nonzeros.
+template <typename Fn> Csr generate(size_t n, Fn rowLength) {
+  std::mt19937 gen{3};
+  std::uniform_int_distribution<uint32_t> col{0, static_cast<uint32_t>(n - 1)};
+  std::uniform_real_distribution<float> val{-1.0f, 1.0f};
+  std::vector<Triplet> t;
+  for (size_t r = 0; r < n; r++) {
+    size_t len = std::min(rowLength(gen), n);
+    for (size_t k = 0; k < len; k++)
+      t.push_back({static_cast<uint32_t>(r), col(gen), val(gen)});
+  }
+  return fromTriplets(n, n, t);
+}
+
+// The matrix in device memory
+struct DeviceCsr {
+  size_t rows, nnz;
+  uint32_t *rowPtr, *col;
+  float *val;
+};
+
+class RowPerItem;
+class RowPerSubGroup;
+class MergePath;
+class MergeFixup;
+
+// One row per work-item. Work-items with short rows wait for the work-item
+// of the longest row in their sub-group, and neighboring work-items read
+// memory far apart.
+sycl::event rowPerItem(sycl::queue &q, DeviceCsr a, const float *x,
+                       float *y) {
+  return q.parallel_for<RowPerItem>(a.rows, [=](sycl::id<1> r) {
+    float sum = 0.0f;
+    for (uint32_t j = a.rowPtr[r]; j < a.rowPtr[r + 1]; j++)
+      sum += a.val[j] * x[a.col[j]];
+    y[r] = sum;
+  });
+}
+
+constexpr size_t groupSize = 128;
+
+// One row per sub-group. The work-items of a sub-group read consecutive
+// nonzeros of the row and add their sums with reduce_over_group. The loop
+// over rows makes the kernel correct for any sub-group size; the launch has
+// one sub-group per row for sub-groups of 16 work-items.
+sycl::event rowPerSubGroup(sycl::queue &q, DeviceCsr a, const float *x,
+                           float *y) {
+  size_t global = (a.rows * 16 + groupSize - 1) / groupSize * groupSize;
+  return q.parallel_for<RowPerSubGroup>(
+      sycl::nd_range<1>{global, groupSize}, [=](sycl::nd_item<1> it) {
+        sycl::sub_group sg = it.get_sub_group();
+        size_t subGroups = sg.get_group_linear_range();
+        size_t first =
+            it.get_group_linear_id() * subGroups + sg.get_group_linear_id();
+        size_t stride = it.get_group_range(0) * subGroups;
+        size_t lanes = sg.get_local_linear_range();
+        for (size_t r = first; r < a.rows; r += stride) {
+          float sum = 0.0f;
+          for (size_t j = a.rowPtr[r] + sg.get_local_linear_id();
+               j < a.rowPtr[r + 1]; j += lanes)
+            sum += a.val[j] * x[a.col[j]];
+          sum = sycl::reduce_over_group(sg, sum, sycl::plus<float>());
+          if (sg.leader())
+            y[r] = sum;
+        }
+      });
+}
+
+constexpr size_t pathPerItem = 16;
+
+// Work-items needed by mergePath
+size_t mergeItems(const DeviceCsr &a) {
+  return (a.rows + a.nnz + pathPerItem - 1) / pathPerItem;
+}
+
+// Merge path: the work is the merge of the row ends with the nonzeros,
+// rows + nnz steps, and every work-item takes an equal share of steps
+// whatever the row lengths. A work-item finds its start by a binary search
+// along its diagonal of the merge, writes the rows that end in its share,
+// and leaves the partial sum of the row it stops in to a second kernel,
+// which adds it atomically.
+sycl::event mergePath(sycl::queue &q, DeviceCsr a, const float *x, float *y,
+                      uint32_t *carryRow, float *carryVal) {
+  size_t total = a.rows + a.nnz;
+  size_t items = mergeItems(a);
+  sycl::event merge = q.parallel_for<MergePath>(items, [=](sycl::id<1> t) {
+    size_t diagonal = std::min(t[0] * pathPerItem, total);
+    size_t end = std::min(diagonal + pathPerItem, total);
+    // The number of rows ended before the diagonal
+    size_t lo = diagonal > a.nnz ? diagonal - a.nnz : 0;
+    size_t hi = std::min(diagonal, a.rows);
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if (a.rowPtr[mid + 1] <= diagonal - mid - 1)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    size_t r = lo, j = diagonal - lo;
+    float sum = 0.0f;
+    for (size_t d = diagonal; d < end; d++) {
+      if (j < a.rowPtr[r + 1]) {
+        sum += a.val[j] * x[a.col[j]];
+        j++;
+      } else {
+        y[r++] = sum;
+        sum = 0.0f;
+      }
+    }
+    carryRow[t] = static_cast<uint32_t>(r);
+    carryVal[t] = sum;
+  });
+  return q.parallel_for<MergeFixup>(
+      sycl::range<1>{items}, merge, [=](sycl::id<1> t) {
+        if (carryRow[t] < a.rows) {
+          sycl::atomic_ref<float, sycl::memory_order::relaxed,
+                           sycl::memory_scope::device,
+                           sycl::access::address_space::global_space>
+              yr{y[carryRow[t]]};
+          yr += carryVal[t];
+        }
+      });
+}
+
+// Best of three runs, after one warm-up run. Wall-clock time, since merge
+// path is two kernels.
+template <typename Fn> double bestSeconds(sycl::queue &q, Fn launch) {
+  launch();
+  q.wait();
+  double best = 1e30;
+  for (int r = 0; r < 3; r++) {
+    auto start = std::chrono::steady_clock::now();
+    launch();
+    q.wait();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    best = std::min(best, d.count());
+  }
+  return best;
+}
+
+bool run(sycl::queue &q, const std::string &name, const Csr &m) {
+  size_t nnz = m.val.size();
+  uint32_t longest = 0;
+  for (size_t r = 0; r < m.rows; r++)
+    longest = std::max(longest, m.rowPtr[r + 1] - m.rowPtr[r]);
+  std::cout << "Matrix: " << name << ", " << m.rows << " x " << m.cols
+            << ", " << nnz << " nonzeros, longest row " << longest << "\n";
+
+  std::mt19937 gen{5};
+  std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+  std::vector<float> hx(m.cols);
+  for (float &v : hx)
+    v = dist(gen);
+
+  // The reference in double, and the sum of the magnitudes of the products
+  // of each row, which bounds the rounding error of any summation order
+  std::vector<double> ref(m.rows), mag(m.rows);
+  for (size_t r = 0; r < m.rows; r++) {
+    for (uint32_t j = m.rowPtr[r]; j < m.rowPtr[r + 1]; j++) {
+      double p = static_cast<double>(m.val[j]) * hx[m.col[j]];
+      ref[r] += p;
+      mag[r] += std::abs(p);
+    }
+  }
+
+  DeviceCsr a{m.rows, nnz, sycl::malloc_device<uint32_t>(m.rows + 1, q),
+              sycl::malloc_device<uint32_t>(nnz, q),
+              sycl::malloc_device<float>(nnz, q)};
+  float *x = sycl::malloc_device<float>(m.cols, q);
+  float *y = sycl::malloc_device<float>(m.rows, q);
+  uint32_t *carryRow = sycl::malloc_device<uint32_t>(mergeItems(a), q);
+  float *carryVal = sycl::malloc_device<float>(mergeItems(a), q);
+  q.copy(m.rowPtr.data(), a.rowPtr, m.rows + 1);
+  q.copy(m.col.data(), a.col, nnz);
+  q.copy(m.val.data(), a.val, nnz);
+  q.copy(hx.data(), x, m.cols);
+  q.wait();
+
+  // The least memory traffic: every nonzero and its column index, the row
+  // pointers, and x and y once each
+  double bytes = nnz * 8.0 + (m.rows + 1) * 4.0 + m.cols * 4.0 + m.rows * 4.0;
+
+  std::cout << std::left << std::setw(22) << "kernel" << std::right
+            << std::setw(10) << "ms" << std::setw(10) << "GFLOPS"
+            << std::setw(10) << "GB/s" << "\n";
+  bool ok = true;
+  auto measure = [&](const char *kernel, auto launch) {
+    q.fill(y, 0.0f, m.rows).wait();
+    double s = bestSeconds(q, launch);
+    std::vector<float> hy(m.rows);
+    q.copy(y, hy.data(), m.rows).wait();
+    for (size_t r = 0; r < m.rows; r++)
+      ok = ok && std::abs(hy[r] - ref[r]) <= 1e-4 * mag[r] + 1e-6;
+    std::cout << std::left << std::setw(22) << kernel << std::right
+              << std::fixed << std::setprecision(3) << std::setw(10)
+              << s * 1e3 << std::setprecision(1) << std::setw(10)
+              << 2.0 * nnz / s / 1e9 << std::setw(10) << bytes / s / 1e9
+              << "\n";
+  };
+  measure("row per work-item", [&]() { return rowPerItem(q, a, x, y); });
+  measure("row per sub-group", [&]() { return rowPerSubGroup(q, a, x, y); });
+  measure("merge path",
+          [&]() { return mergePath(q, a, x, y, carryRow, carryVal); });
+
+  sycl::free(a.rowPtr, q);
+  sycl::free(a.col, q);
+  sycl::free(a.val, q);
+  sycl::free(x, q);
+  sycl::free(y, q);
+  sycl::free(carryRow, q);
+  sycl::free(carryVal, q);
+  return ok;
+}
+
+// The first argument is a Matrix Market file to use instead of the
+// generated matrices
+int main(int argc, char *argv[]) {
+  sycl::queue q;
+  bool ok = true;
+  try {
+    if (argc > 1) {
+      ok = run(q, argv[1], readMatrixMarket(argv[1]));
+    } else {
+      constexpr size_t n = 1 << 20;
+      // Every row has 12 nonzeros
+      ok = run(q, "uniform", generate(n, [](std::mt19937 &) {
+                 return size_t{12};
+               }));
+      // Pareto distributed row lengths with the same mean: most rows are
+      // short, and a few have tens of thousands of nonzeros
+      ok = run(q, "power law", generate(n, [](std::mt19937 &gen) {
+                 std::uniform_real_distribution<double> u{0.0, 1.0};
+                 return static_cast<size_t>(4.0 /
+                                            std::pow(1.0 - u(gen), 1 / 1.5));
+               })) &&
+           ok;
+    }
+  } catch (const std::runtime_error &e) {
+    std::cout << e.what() << "\n";
+    return 1;
+  }
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+template <int N> class ScaleVec;
+template <int N> class ScaleLoadStore;
+template <int N> class Polynomial;
+
+constexpr int polyIters = 64;
+
+// Best of three profiled runs, after one warm-up run
+template <typename Fn> double bestSeconds(Fn launch) {
+  launch().wait();
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int r = 0; r < 3; r++) {
+    sycl::event e = launch();
+    e.wait();
+    best = std::min(
+        best,
+        e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+            e.get_profiling_info<
+                sycl::info::event_profiling::command_start>());
+  }
+  return best / 1.0e9;
+}
+
+// Runs the kernels for one vector width over the same number of floats and
+// prints one row of the table
+template <int N> bool sweep(sycl::queue &q, size_t numFloats) {
+  using vec_t = sycl::vec<float, N>;
+  size_t count = numFloats / N;
+
+  // Array of vec: a vec<float, 3> occupies the space of 4 floats
+  vec_t *in = sycl::malloc_device<vec_t>(count, q);
+  vec_t *out = sycl::malloc_device<vec_t>(count, q);
+  // Packed floats, accessed N at a time with vec::load and vec::store
+  float *flatIn = sycl::malloc_device<float>(count * N, q);
+  float *flatOut = sycl::malloc_device<float>(count * N, q);
+  q.fill(in, vec_t(1.0f), count);
+  q.fill(flatIn, 1.0f, count * N);
+  q.wait();
+
+  double vecS = bestSeconds([&]() {
+    return q.parallel_for<ScaleVec<N>>(
+        count, [=](sycl::id<1> i) { out[i] = in[i] * 2.0f; });
+  });
+
+  const float *src = flatIn;
+  float *dst = flatOut;
+  double loadS = bestSeconds([&]() {
+    return q.parallel_for<ScaleLoadStore<N>>(count, [=](sycl::id<1> i) {
+      auto srcPtr = sycl::address_space_cast<
+          sycl::access::address_space::global_space,
+          sycl::access::decorated::no>(src);
+      auto dstPtr = sycl::address_space_cast<
+          sycl::access::address_space::global_space,
+          sycl::access::decorated::no>(dst);
+      vec_t v;
+      v.load(i[0], srcPtr);
+      (v * 2.0f).store(i[0], dstPtr);
+    });
+  });
+
+  double polyS = bestSeconds([&]() {
+    return q.parallel_for<Polynomial<N>>(count, [=](sycl::id<1> i) {
+      vec_t x = in[i];
+      for (int k = 0; k < polyIters; k++)
+        x = x * 0.999f + 0.001f;
+      out[i] = x;
+    });
+  });
+
+  double usefulBytes = 2.0 * count * N * sizeof(float);
+  double movedBytes = 2.0 * count * sizeof(vec_t);
+  double flops = 2.0 * polyIters * N * count;
+  std::cout << std::setw(3) << N << std::setw(8) << sizeof(vec_t)
+            << std::setw(12) << movedBytes / vecS / 1e9 << std::setw(12)
+            << usefulBytes / vecS / 1e9 << std::setw(12)
+            << usefulBytes / loadS / 1e9 << std::setw(12)
+            << flops / polyS / 1e9 << "\n";
+
+  vec_t v;
+  float f[2];
+  q.copy(out, &v, 1);
+  q.copy(flatOut, &f[0], 1);
+  q.copy(flatOut + count * N - 1, &f[1], 1);
+  q.wait();
+  bool ok = f[0] == 2.0f && f[1] == 2.0f;
+  for (int j = 0; j < N; j++)
+    ok = ok && std::fabs(v[j] - 1.0f) < 1e-4f;
+
+  sycl::free(in, q);
+  sycl::free(out, q);
+  sycl::free(flatIn, q);
+  sycl::free(flatOut, q);
+  return ok;
+}
+
+int main() {
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+  std::cout << "Device: "
+            << q.get_device().get_info<sycl::info::device::name>() << "\n";
+
+  // The same amount of data for every width, 64 MiB per array
+  constexpr size_t numFloats = 1 << 24;
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << std::setw(3) << "N" << std::setw(8) << "bytes"
+            << std::setw(12) << "moved GB/s" << std::setw(12) << "useful GB/s"
+            << std::setw(12) << "ld/st GB/s" << std::setw(12) << "GFLOPS"
+            << "\n";
+  bool ok = sweep<1>(q, numFloats);
+  ok = sweep<2>(q, numFloats) && ok;
+  ok = sweep<3>(q, numFloats) && ok;
+  ok = sweep<4>(q, numFloats) && ok;
+  ok = sweep<8>(q, numFloats) && ok;
+  ok = sweep<16>(q, numFloats) && ok;
+
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+  return ok ? 0 : 1;
+}
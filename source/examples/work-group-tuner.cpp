@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2024 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Chooses the fastest work-group size for a kernel on a device. The
+// candidate sizes come from the kernel and device info descriptors, each
+// candidate is timed with event profiling, and the winner is cached per
+// device and kernel. A device is identified by its backend, name and driver
+// version, since a different backend or driver for the same hardware can
+// favor a different size.
+class WorkGroupTuner {
+public:
+  explicit WorkGroupTuner(std::ostream *log = nullptr) : log_{log} {}
+
+  // `launch` submits the kernel with the given local size and returns the
+  // event of that submission. The queue must have the enable_profiling
+  // property. `label` names the kernel in the log, since kernel_id names
+  // are implementation-defined and often mangled.
+  template <typename KernelName, typename LaunchFn>
+  size_t tune(sycl::queue &q, const std::string &label, LaunchFn launch,
+              int repetitions = 5) {
+    sycl::device dev = q.get_device();
+    sycl::kernel_id id = sycl::get_kernel_id<KernelName>();
+    Key key{dev.get_backend(), dev.get_info<sycl::info::device::name>(),
+            dev.get_info<sycl::info::device::driver_version>(), id.get_name()};
+
+    if (auto it = cache_.find(key); it != cache_.end()) {
+      if (log_)
+        *log_ << label << ": cached local size " << it->second << "\n";
+      return it->second;
+    }
+
+    // Building the bundle here also moves the JIT cost out of the timing
+    auto bundle = sycl::get_kernel_bundle<sycl::bundle_state::executable>(
+        q.get_context(), {dev}, {id});
+    sycl::kernel k = bundle.get_kernel(id);
+
+    if (log_)
+      *log_ << "Tuning " << label << "\n";
+
+    size_t best = 0;
+    uint64_t bestTime = std::numeric_limits<uint64_t>::max();
+    for (size_t local : candidates(k, dev)) {
+      // Warm-up run
+      launch(local).wait();
+
+      uint64_t time = std::numeric_limits<uint64_t>::max();
+      for (int r = 0; r < repetitions; ++r) {
+        sycl::event e = launch(local);
+        e.wait();
+        time = std::min(time, elapsed(e));
+      }
+      if (log_)
+        *log_ << "  local size " << std::setw(5) << local << ": "
+              << std::fixed << std::setprecision(3) << time / 1.0e6
+              << " ms\n";
+      if (time < bestTime) {
+        bestTime = time;
+        best = local;
+      }
+    }
+
+    cache_[key] = best;
+    return best;
+  }
+
+private:
+  // Backend, device name, driver version and kernel name
+  using Key = std::tuple<sycl::backend, std::string, std::string, std::string>;
+
+  // Powers of two times the preferred multiple, up to the largest size the
+  // kernel supports on this device.
+  static std::vector<size_t> candidates(const sycl::kernel &k,
+                                        const sycl::device &dev) {
+    size_t maxSize = std::min(
+        k.get_info<sycl::info::kernel_device_specific::work_group_size>(dev),
+        dev.get_info<sycl::info::device::max_work_group_size>());
+    size_t multiple = std::max<size_t>(
+        1, k.get_info<sycl::info::kernel_device_specific::
+                          preferred_work_group_size_multiple>(dev));
+
+    std::vector<size_t> sizes;
+    for (size_t s = std::min(multiple, maxSize); s <= maxSize; s *= 2)
+      sizes.push_back(s);
+    if (sizes.back() != maxSize)
+      sizes.push_back(maxSize);
+    return sizes;
+  }
+
+  static uint64_t elapsed(const sycl::event &e) {
+    return e.get_profiling_info<sycl::info::event_profiling::command_end>() -
+           e.get_profiling_info<sycl::info::event_profiling::command_start>();
+  }
+
+  std::ostream *log_;
+  std::map<Key, size_t> cache_;
+};
+
+class ReduceKernel;
+class StencilKernel;
+
+size_t roundUp(size_t n, size_t multiple) {
+  return (n + multiple - 1) / multiple * multiple;
+}
+
+// Sum of `in` added to `*sum`, one work-group reduction per group
+sycl::event reduce(sycl::queue &q, const float *in, float *sum, size_t n,
+                   size_t local) {
+  sycl::nd_range<1> ndr{roundUp(n, local), local};
+  return q.parallel_for<ReduceKernel>(ndr, [=](sycl::nd_item<1> it) {
+    size_t i = it.get_global_id(0);
+    float groupSum = sycl::reduce_over_group(
+        it.get_group(), i < n ? in[i] : 0.0f, sycl::plus<>());
+    if (it.get_group().leader()) {
+      sycl::atomic_ref<float, sycl::memory_order::relaxed,
+                       sycl::memory_scope::device>
+          ref(*sum);
+      ref.fetch_add(groupSum);
+    }
+  });
+}
+
+// 3-point stencil with the work-group's inputs staged in local memory
+sycl::event stencil(sycl::queue &q, const float *in, float *out, size_t n,
+                    size_t local) {
+  sycl::nd_range<1> ndr{roundUp(n, local), local};
+  return q.submit([&](sycl::handler &cgh) {
+    sycl::local_accessor<float, 1> tile{local + 2, cgh};
+    cgh.parallel_for<StencilKernel>(ndr, [=](sycl::nd_item<1> it) {
+      // Out of range indices, including 0 - 1, read as zero
+      auto load = [=](size_t j) { return j < n ? in[j] : 0.0f; };
+      size_t i = it.get_global_id(0);
+      size_t l = it.get_local_id(0) + 1;
+
+      tile[l] = load(i);
+      if (l == 1)
+        tile[0] = load(i - 1);
+      if (l == local)
+        tile[local + 1] = load(i + 1);
+      sycl::group_barrier(it.get_group());
+
+      if (i < n)
+        out[i] = 0.25f * tile[l - 1] + 0.5f * tile[l] + 0.25f * tile[l + 1];
+    });
+  });
+}
+
+int main() {
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+  std::cout << "Device: "
+            << q.get_device().get_info<sycl::info::device::name>() << "\n";
+
+  constexpr size_t n = 1 << 22;
+  float *in = sycl::malloc_device<float>(n, q);
+  float *out = sycl::malloc_device<float>(n, q);
+  float *sum = sycl::malloc_shared<float>(1, q);
+  q.fill(in, 1.0f, n).wait();
+
+  WorkGroupTuner tuner{&std::cout};
+  auto reduceLaunch = [&](size_t local) {
+    return reduce(q, in, sum, n, local);
+  };
+  auto stencilLaunch = [&](size_t local) {
+    return stencil(q, in, out, n, local);
+  };
+
+  size_t reduceLocal = tuner.tune<ReduceKernel>(q, "reduction", reduceLaunch);
+  size_t stencilLocal =
+      tuner.tune<StencilKernel>(q, "stencil", stencilLaunch);
+
+  // Later requests for the same device and kernel are served from the cache
+  tuner.tune<ReduceKernel>(q, "reduction", reduceLaunch);
+
+  std::cout << "Best local size for reduction: " << reduceLocal << "\n";
+  std::cout << "Best local size for stencil: " << stencilLocal << "\n";
+
+  // Check both kernels with the chosen sizes
+  *sum = 0.0f;
+  reduce(q, in, sum, n, reduceLocal).wait();
+  stencil(q, in, out, n, stencilLocal).wait();
+
+  float samples[3];
+  q.copy(out, &samples[0], 1);
+  q.copy(out + n / 2, &samples[1], 1);
+  q.copy(out + n - 1, &samples[2], 1);
+  q.wait();
+
+  bool ok = *sum == static_cast<float>(n) && samples[0] == 0.75f &&
+            samples[1] == 1.0f && samples[2] == 0.75f;
+  std::cout << (ok ? "Results verified" : "Verification failed") << "\n";
+
+  sycl::free(in, q);
+  sycl::free(out, q);
+  sycl::free(sum, q);
+  return ok ? 0 : 1;
+}